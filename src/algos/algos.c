@@ -20,6 +20,15 @@
 #include "branch_and_bound.h"
 #include "minimum_spanning_tree.h"
 #include "branch_and_bound_hk.h"
+#include "christofides.h"
+#include "two_opt.h"
+#include "or_opt.h"
+#include "lin_kernighan.h"
+#include "greedy_edge.h"
+#include "clarke_wright.h"
+#include "hilbert.h"
+#include "insertion.h"
+#include "held_karp.h"
 #include "../tsp.h"
 
 /** \struct algos
@@ -33,6 +42,9 @@ struct _algos
 {
     City*(*fcts[NB_ALGOS])(Map, City);
     Str names[NB_ALGOS];
+    void(*improves[NB_IMPROVES])(Map, City*); /*!< Heuristiques d'amélioration, appliquées dans l'ordre au chemin d'un algorithme. */
+    Str improveNames[NB_IMPROVES];
+    bool improveSelected[NB_IMPROVES];
 } algos;
 
 /** \fn void initAlgos()
@@ -51,6 +63,17 @@ void initAlgos()
     algos.fcts[5]=&bruteForce_mt;
     algos.fcts[6]=&branchAndBoundNNMST;
     algos.fcts[7]=&branchAndBoundHK;
+    algos.fcts[8]=&nearestNeighbourMulti;
+    algos.fcts[9]=&christofides;
+    algos.fcts[10]=&linKernighan;
+    algos.fcts[11]=&greedyEdge;
+    algos.fcts[12]=&clarkeWright;
+    algos.fcts[13]=&hilbertCurve;
+    algos.fcts[14]=&nearestInsertion;
+    algos.fcts[15]=&farthestInsertion;
+    algos.fcts[16]=&cheapestInsertion;
+    algos.fcts[17]=&convexHullInsertion;
+    algos.fcts[18]=&heldKarp;
     algos.names[0]="Nearest Neighbour";
     algos.names[1]="Minimum Spanning Tree";
     algos.names[2]="Iterative Brute Force";
@@ -59,6 +82,37 @@ void initAlgos()
     algos.names[5]="Multi-threaded BruteForce";
     algos.names[6]="Branch and Bound with NN-MST relaxation";
     algos.names[7]="Branch and Bound with Held Karp relaxation";
+    algos.names[8]="Multi-start Nearest Neighbour";
+    algos.names[9]="Christofides";
+    algos.names[10]="Lin-Kernighan";
+    algos.names[11]="Greedy Edge";
+    algos.names[12]="Clarke-Wright Savings";
+    algos.names[13]="Hilbert Curve";
+    algos.names[14]="Nearest Insertion";
+    algos.names[15]="Farthest Insertion";
+    algos.names[16]="Cheapest Insertion";
+    algos.names[17]="Convex Hull Insertion";
+    algos.names[18]="Held-Karp Dynamic Programming";
+    algos.improves[0]=&twoOpt;
+    algos.improves[1]=&orOpt;
+    algos.improveNames[0]="2-opt";
+    algos.improveNames[1]="Or-opt";
+
+    for(int i=0; i<NB_IMPROVES; i++)
+        algos.improveSelected[i]=false;
+}
+
+/** \fn void setImprove(int i, bool val)
+ *
+ * \brief Active ou désactive une heuristique d'amélioration, appliquée par executeAlgos au chemin de chaque algorithme
+ * \param i indice de l'amélioration (0 : 2-opt, 1 : Or-opt)
+ * \param val true pour l'appliquer
+ *
+ */
+
+void setImprove(int i, bool val)
+{
+    algos.improveSelected[i]=val;
 }
 
 /** \fn void printTest(int nbCities, int nbTests, bool* algosSelected)
@@ -125,6 +179,19 @@ void printAlgoResult(Map m, City *path)
     printf("Total Length: %f\n", calcPathLength(m, path));
 }
 
+/** \fn static City *bestPath(Map m, int i)
+ *
+ * \brief Retourne le chemin gardé de l'algorithme i : le chemin amélioré s'il existe, celui de l'algorithme sinon
+ * \param m Map choisie pour la résolution de l'algorithme
+ * \param i indice de l'algorithme
+ *
+ */
+
+static City *bestPath(Map m, int i)
+{
+    return mapGetImprovedPath(m, i) ? mapGetImprovedPath(m, i) : mapGetPath(m, i);
+}
+
 /** \fn executeAlgos(Map m, bool *algosSelected, int startC, bool graphics, bool tour)
  *
  * \brief
@@ -152,6 +219,12 @@ void executeAlgos(Map m, bool *algosSelected, int startC, bool graphics, bool to
                 free(mapGetPath(m, i));
                 mapSetPath(m, i, NULL);
             }
+
+            if(mapGetImprovedPath(m, i))
+            {
+                free(mapGetImprovedPath(m, i));
+                mapSetImprovedPath(m, i, NULL);
+            }
         }
 
     mapSetStartCity(m, startC);
@@ -170,8 +243,36 @@ void executeAlgos(Map m, bool *algosSelected, int startC, bool graphics, bool to
             printf("%s Result: (%.3f ms)\n", algos.names[i], mapGetDuration(m, i));
             printAlgoResult(m, mapGetPath(m, i));
 
+            City *improved=NULL; // les améliorations portent sur une copie : le chemin gardé reste celui de l'algorithme
+            double duration=mapGetDuration(m, i);
+
+            for(int j=0; j<NB_IMPROVES; j++)
+                if(algos.improveSelected[j])
+                {
+                    if(!improved)
+                    {
+                        improved=arrCitiesCreate(mapGetSize(m)+1);
+
+                        for(int k=0; k<=mapGetSize(m); k++)
+                            improved[k]=mapGetPath(m, i)[k];
+                    }
+
+                    clockBegin();
+                    algos.improves[j](m, improved);
+                    double improveDuration=clockStop();
+
+                    duration+=improveDuration;
+                    printf("%s + %s Result: (%.3f ms)\n", algos.names[i], algos.improveNames[j], improveDuration);
+                    printAlgoResult(m, improved);
+                }
+
+            if(mapGetImprovedPath(m, i))
+                free(mapGetImprovedPath(m, i));
+            mapSetImprovedPath(m, i, improved);
+            mapSetImprovedDuration(m, i, duration);
+
             if(graphics)
-                guiAddPath(m, mapGetPath(m, i), mapGetDuration(m, i));
+                guiAddPath(m, improved ? improved : mapGetPath(m, i), duration);
         }
     }
 
@@ -196,7 +297,7 @@ void executeAlgos(Map m, bool *algosSelected, int startC, bool graphics, bool to
         {
             if(mapGetPath(m, i))
             {
-                lengths[i]=calcPathLength(m, mapGetPath(m, i));
+                lengths[i]=calcPathLength(m, bestPath(m, i));
 
                 if(!initI)
                 {
@@ -222,7 +323,7 @@ void executeAlgos(Map m, bool *algosSelected, int startC, bool graphics, bool to
         newname[le++]='r';
         newname[le]='\0';
 
-        tspOut(m, mapGetPath(m, minI), newname, algos.names[minI]);
+        tspOut(m, bestPath(m, minI), newname, algos.names[minI]);
 
         free(newname);
     }
@@ -242,7 +343,7 @@ double calcPathLength(Map m, City *path)
     double s=0;
 
     for(int i=0; i<mapGetSize(m); i++)
-        s+=cityGetDist(path[i], cityGetIndex(path[i+1]));
+        s+=mapDist(m, cityGetIndex(path[i]), cityGetIndex(path[i+1]));
 
     return s;
 }
@@ -263,7 +364,7 @@ double calcPathLengthFromIndexesArr(Map m, int *indArr)   // path doit contenir
     double s=0;
 
     for(int i=0; i<mapGetSize(m); i++)
-        s+=cityGetDist(mapGetCity(m, indArr[i]),indArr[i+1]);
+        s+=mapDist(m, indArr[i], indArr[i+1]);
 
     return s;
 }
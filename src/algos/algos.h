@@ -12,7 +12,8 @@
 #include "../city.h"
 #include "../map.h"
 
-#define NB_ALGOS 8
+#define NB_ALGOS 19
+#define NB_IMPROVES 2
 
 /** \fn void initAlgos()
  *
@@ -20,6 +21,14 @@
  *
  */
 void initAlgos();
+/** \fn void setImprove(int i, bool val)
+ *
+ * \brief Active ou désactive une heuristique d'amélioration, appliquée par executeAlgos au chemin de chaque algorithme
+ * \param i indice de l'amélioration (0 : 2-opt, 1 : Or-opt)
+ * \param val true pour l'appliquer
+ *
+ */
+void setImprove(int i, bool val);
 /** \fn void printTest(int nbCities, int nbTests, bool* algosSelected)
  *
  * \brief A pour rôle d'afficher le test des algorithmes choisis (temps d'exécution,
@@ -15,6 +15,7 @@
 #include "branch_and_bound.h"
 #include "nearest_neighbour.h"
 #include "minimum_spanning_tree.h"
+#include "insertion.h"
 
 /**
  * \fn static voic permut_bb(Map m, int *t, int iBegin, int size, double* minLength, int** minArr)
@@ -47,7 +48,7 @@ static void permut_bb(Map m, int* t, int iBegin, int size , double* minLength, i
             length=0;
             //Calculer distance jusqu'a iBegin, comparer vec minlength
             for(int i=0; i<iBegin; i++)
-                length+=cityGetDist(mapGetCity(m, t[i]),t[i+1]);
+                length+=mapDist(m, t[i], t[i+1]);
 
             if(length>*minLength) // pas la peine d'aller plus loin dans la branche --  bound
                 break;
@@ -122,7 +123,7 @@ City* branchAndBoundNNMST(Map m, City c)
     int *minArr=arrIndexesCreate(nbCities+1);
 
     ///City* minArrNN=arrCitiesCreate(nbCities+1);
-    City* minArrNN=nearestNeighbour(m, c);
+    City* minArrNN=nearestNeighbourMulti(m, c); // borne initiale : meilleur NN sur tous les départs
     double minLength=calcPathLength(m,minArrNN);
 
     //City *minArrMST=arrCitiesCreate(nbCities+1);
@@ -142,6 +143,14 @@ City* branchAndBoundNNMST(Map m, City c)
         freeArrCities(minArrNN);
     }
 
+    City* minArrFI=farthestInsertion(m, c); // souvent bien plus court que NN et MST
+    if(calcPathLength(m,minArrFI)<minLength)
+    {
+        for(int i=0; i<nbCities+1; i++) minArr[i]=cityGetIndex(minArrFI[i]);
+        minLength=calcPathLength(m, minArrFI);
+    }
+    freeArrCities(minArrFI);
+
     permut_bb(m,t,1,nbCities,&minLength,&minArr);
 
     City* arrCity=arrCitiesCreate(nbCities+1);
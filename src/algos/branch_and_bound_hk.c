@@ -10,11 +10,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <float.h> //DBL_MIN, DBL_MAX
+#include <math.h>
 #include "algos.h"
 #include "../fcts.h"
 #include "pri_queue.h"
 #include "vertex.h"
 #include "branch_and_bound_hk.h"
+#include "nearest_neighbour.h"
+#include "christofides.h"
 
 
 
@@ -83,7 +86,7 @@ static void doOneTree(vertex_t * vertex)
     for (i = 0; i < n; i++)
     {
         for (j = 0; j < n; j++)
-            adjustedDist[i][j] = (vertex->excluded[i].ptr[j] == 1)? DBL_MAX : cityGetDist(mapGetCity(map, i),j) + vertex->adjusted[i] + vertex->adjusted[j];
+            adjustedDist[i][j] = (vertex->excluded[i].ptr[j] == 1)? DBL_MAX : mapDist(map, i, j) + vertex->adjusted[i] + vertex->adjusted[j];
     }
     int firstNeighbor;
     int secondNeighbor;
@@ -280,10 +283,24 @@ City *branchAndBoundHK(Map m, City startCity)
         return path;
     }
 
+    if(!mapIsSymmetric(m)) // le 1-arbre est non orienté : ses bornes ne minorent pas un chemin orienté
+    {
+        throwWarn("BranchAndBoundHK", "Distances are not symmetric, returning the nearestNeighbourMulti path (branchAndBoundHK)", NULL);
+        return nearestNeighbourMulti(m, startCity);
+    }
+
     bbrhk_alloc(m);
 
     bestVertex = vertex_new(n);
-    bestVertex->lowerBound = DBL_MAX;
+
+    City *pathNN = nearestNeighbourMulti(m, startCity); // bornes supérieures initiales : les sommets qui ne peuvent pas faire mieux sont élagués dès le départ
+    City *pathChr = christofides(m, startCity);
+    double lengthNN = calcPathLength(m, pathNN), lengthChr = calcPathLength(m, pathChr);
+    City *pathHeur = lengthChr < lengthNN ? pathChr : pathNN; // rendu si aucun chemin ne fait mieux
+    double upperBound = fmin(lengthNN, lengthChr);
+    freeArrCities(pathHeur == pathChr ? pathNN : pathChr);
+    bestVertex->lowerBound = upperBound + 1e-9 * (upperBound + 1); // marge pour que le chemin optimal (éventuellement l'un de ces deux chemins) soit trouvé
+    bool found = false; // bestVertex remplacé par un chemin de l'arbre
 
     vertex_t* currentVertex = vertex_new(n);
 
@@ -308,9 +325,9 @@ City *branchAndBoundHK(Map m, City startCity)
                 if (currentVertex->lowerBound < bestVertex->lowerBound) // comparaison avec le meilleur
                 {
                     vertex_copy(bestVertex, currentVertex, n); // on le remplace
-                    break;
+                    found = true;
                 }
-
+                break; // un chemin n'a pas de fils : élagué s'il ne fait pas mieux
             }
 
             pri_queue children = priq_new(11);
@@ -340,16 +357,22 @@ City *branchAndBoundHK(Map m, City startCity)
     while( (currentVertex != NULL) &&
             (currentVertex->lowerBound < bestVertex->lowerBound) );
 
-    int j = 0;
-    int k = 0;
-    do
+    if(found)
     {
-        int i = bestVertex->parent[j];
-        arrCity[k++]=mapGetCity(m,i);
-        j = i;
+        int j = 0;
+        int k = 0;
+        do
+        {
+            int i = bestVertex->parent[j];
+            arrCity[k++]=mapGetCity(m,i);
+            j = i;
+        }
+        while (j != 0);
+        arrCity[k]=arrCity[0];
     }
-    while (j != 0);
-    arrCity[k]=arrCity[0];
+    else
+        memcpy(arrCity, pathHeur, (n+1)*sizeof(City));
+    freeArrCities(pathHeur);
 
     vertex_t * vertex;
     while((vertex = priq_pop(pq, 0)) != NULL)
@@ -63,7 +63,7 @@ static void permut_bf(Map m, int* t, int iBegin, int size , double* minLength, i
             length=0;
             //Calculer distance jusqu'a iBegin, comparer vec minlength
             for(int i=0; i<iBegin; i++)
-                length+=cityGetDist(mapGetCity(m, t[i]),t[i+1]);
+                length+=mapDist(m, t[i], t[i+1]);
 
             int tmp=t[i];
             t[i]=t[iBegin];
@@ -0,0 +1,149 @@
+/**
+ * \file christofides.c
+ * \brief Fichier implémentant l'algorithme de Christofides.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * L'arbre couvrant minimum est complété par un couplage parfait de poids minimum de ses sommets de degré impair : le
+ * multigraphe obtenu a tous ses degrés pairs, son cycle eulérien (Hierholzer) est raccourci en sautant les villes déjà
+ * visitées. Le chemin est au plus 1,5 fois l'optimal quand les distances vérifient l'inégalité triangulaire et que le
+ * couplage est optimal (voir MATCHING_BLOSSOM_MAX).
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "../city.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "christofides.h"
+#include "minimum_spanning_tree.h"
+#include "matching.h"
+
+/**
+ * \fn City* christofides(Map m, City cityBegin)
+ * \brief Fonction qui exécute l'algorithme de Christofides.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City cityBegin : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* christofides(Map m, City cityBegin)
+{
+    int nbCities=mapGetSize(m);
+    City* path=arrCitiesCreate(nbCities+1);
+    int root=cityGetIndex(cityBegin);
+    int nbEdges=nbCities-1;
+    int nbOdd=0;
+    int *fathers=malloc(nbCities*sizeof(int));
+    int *sons=malloc(nbCities*sizeof(int));
+    int *degree=calloc(nbCities, sizeof(int));
+
+    minimumSpanningTreeEdges(m, root, fathers, sons);
+
+    for(int e=0; e<nbEdges; e++)
+    {
+        degree[fathers[e]]++;
+        degree[sons[e]]++;
+    }
+
+    for(int i=0; i<nbCities; i++)
+        nbOdd+=degree[i]%2;
+
+    int *ends=malloc((3*nbCities+1)*sizeof(int)); // extrémités des arêtes du multigraphe : arbre puis couplage
+
+    for(int e=0; e<nbEdges; e++)
+    {
+        ends[2*e]=fathers[e];
+        ends[2*e+1]=sons[e];
+    }
+
+    free(sons);
+    free(fathers);
+
+    int *odd=malloc((nbOdd+1)*sizeof(int));
+
+    nbOdd=0;
+    for(int i=0; i<nbCities; i++)
+        if(degree[i]%2==1)
+            odd[nbOdd++]=i;
+
+    int *mate=malloc((nbOdd+1)*sizeof(int));
+
+    perfectMatching(m, odd, nbOdd, mate);
+
+    for(int i=0; i<nbOdd; i++)
+        if(i<mate[i])
+        {
+            ends[2*nbEdges]=odd[i];
+            ends[2*nbEdges+1]=odd[mate[i]];
+            nbEdges++;
+        }
+
+    free(mate);
+    free(odd);
+
+    // listes d'incidence (CSR) du multigraphe
+    int *first=calloc(nbCities+1, sizeof(int));
+    int *inc=malloc((2*nbEdges+1)*sizeof(int));
+
+    for(int e=0; e<2*nbEdges; e++)
+        first[ends[e]+1]++;
+    for(int i=0; i<nbCities; i++)
+        first[i+1]+=first[i];
+    for(int i=0; i<nbCities; i++)
+        degree[i]=first[i]; // prochaine case libre de i
+    for(int e=0; e<nbEdges; e++)
+    {
+        inc[degree[ends[2*e]]++]=e;
+        inc[degree[ends[2*e+1]]++]=e;
+    }
+    for(int i=0; i<nbCities; i++)
+        degree[i]=first[i]; // prochaine arête à essayer depuis i
+
+    // cycle eulérien (Hierholzer), raccourci au fur et à mesure : les villes sont prises à leur première sortie de la pile
+    bool *used=calloc(nbEdges+1, sizeof(bool));
+    bool *visited=calloc(nbCities, sizeof(bool));
+    int *stack=malloc((nbEdges+1)*sizeof(int));
+    int top=0, nbVisited=0;
+
+    stack[top++]=root;
+
+    while(top>0)
+    {
+        int v=stack[top-1];
+
+        while(degree[v]<first[v+1] && used[inc[degree[v]]])
+            degree[v]++;
+
+        if(degree[v]==first[v+1])
+        {
+            top--;
+            if(!visited[v])
+            {
+                visited[v]=true;
+                path[nbVisited++]=mapGetCity(m, v);
+            }
+        }
+        else
+        {
+            int e=inc[degree[v]];
+            used[e]=true;
+            stack[top++]=ends[2*e]==v ? ends[2*e+1] : ends[2*e];
+        }
+    }
+
+    path[nbCities]=cityBegin; // le cycle part de root et y revient, root est donc la première ville sortie de la pile
+
+    free(stack);
+    free(visited);
+    free(used);
+    free(inc);
+    free(first);
+    free(degree);
+    free(ends);
+
+    return path;
+}
@@ -0,0 +1,25 @@
+/**
+ * \file christofides.h
+ * \brief Fichier d'en-tête de l'algorithme de Christofides.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef CHRISTOFIDES_H_INCLUDED
+#define CHRISTOFIDES_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn City* christofides(Map m, City cityBegin)
+ * \brief Fonction qui exécute l'algorithme de Christofides (arbre couvrant minimum, couplage des sommets impairs, cycle eulérien raccourci).
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City cityBegin : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* christofides(Map m, City cityBegin);
+
+#endif // CHRISTOFIDES_H_INCLUDED
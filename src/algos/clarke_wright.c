@@ -0,0 +1,114 @@
+/**
+ * \file clarke_wright.c
+ * \brief Fichier implémentant l'algorithme des économies de Clarke et Wright.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Chaque ville est d'abord desservie par un aller-retour depuis le dépôt h (la ville de départ). Relier directement i et
+ * j économise s(i, j) = d(h, i) + d(h, j) - d(i, j) : les paires sont prises par économie décroissante et reliées tant que
+ * i et j sont des extrémités de deux tournées différentes (union-find et degrés, comme pour greedyEdge). Seules les paires
+ * de plus proches voisins sont candidates (edgesFromNeighbours), ce qui donne O(nk log n) au lieu de O(n² log n). Les
+ * tournées restantes sont enchaînées depuis le dépôt par greedyJoinFragments.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "../city.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "edges.h"
+#include "greedy_edge.h"
+#include "clarke_wright.h"
+
+/**
+ * \def CW_NEIGHBOURS
+ * \brief Nombre de plus proches voisins par ville dont les paires sont candidates, si la Map n'a pas déjà des listes de voisins.
+ */
+
+#define CW_NEIGHBOURS 10
+
+/**
+ * \fn City* clarkeWright(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme des économies de Clarke et Wright, la ville de départ servant de dépôt.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin (dépôt).
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* clarkeWright(Map m, City c)
+{
+    int nbCities=mapGetSize(m);
+    City *path=arrCitiesCreate(nbCities+1);
+    int hub=cityGetIndex(c);
+
+    if(nbCities<4)
+    {
+        for(int i=0; i<nbCities; i++)
+            path[i]=mapGetCity(m, (hub+i)%nbCities);
+        path[nbCities]=c;
+        return path;
+    }
+
+    if(mapGetNbNeighbours(m)==0)
+        mapBuildNeighbours(m, CW_NEIGHBOURS);
+
+    size_t nbSavings;
+    Edge *savings=edgesFromNeighbours(m, hub, &nbSavings);
+
+    for(size_t e=0; e<nbSavings; e++) // poids : opposé de l'économie, pour trier par économie décroissante
+        savings[e].w=-(mapDist(m, hub, savings[e].u)+mapDist(m, hub, savings[e].v)-savings[e].w);
+
+    qsort(savings, nbSavings, sizeof(Edge), edgesCompare);
+
+    int *set=malloc(nbCities*sizeof(int));
+    int *adj=malloc(2*nbCities*sizeof(int));
+    int *degree=calloc(nbCities, sizeof(int));
+    int nbAdded=0;
+
+    for(int i=0; i<nbCities; i++)
+        set[i]=i;
+
+    for(size_t e=0; e<nbSavings && nbAdded<nbCities-2; e++)
+    {
+        int u=savings[e].u, v=savings[e].v;
+
+        if(degree[u]==2 || degree[v]==2)
+            continue;
+
+        int ru=edgesFind(set, u);
+        int rv=edgesFind(set, v);
+
+        if(ru==rv)
+            continue;
+
+        set[ru]=rv;
+        greedyLink(adj, degree, u, v);
+        nbAdded++;
+    }
+
+    free(savings);
+    free(set);
+
+    greedyJoinFragments(m, adj, degree, hub); // le dépôt, seul, relie les tournées restantes
+
+    int prev=adj[2*hub+1], cur=hub;
+
+    for(int i=0; i<nbCities; i++)
+    {
+        int next=adj[2*cur]!=prev ? adj[2*cur] : adj[2*cur+1];
+
+        path[i]=mapGetCity(m, cur);
+        prev=cur;
+        cur=next;
+    }
+
+    path[nbCities]=c;
+
+    free(degree);
+    free(adj);
+
+    return path;
+}
@@ -0,0 +1,25 @@
+/**
+ * \file clarke_wright.h
+ * \brief Fichier d'en-tête de l'algorithme des économies de Clarke et Wright.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef CLARKE_WRIGHT_H_INCLUDED
+#define CLARKE_WRIGHT_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn City* clarkeWright(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme des économies de Clarke et Wright, la ville de départ servant de dépôt.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin (dépôt).
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* clarkeWright(Map m, City c);
+
+#endif // CLARKE_WRIGHT_H_INCLUDED
@@ -0,0 +1,107 @@
+/**
+ * \file edges.c
+ * \brief Fichier implémentant les outils communs aux algorithmes sur les arêtes vers les plus proches voisins.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * greedyEdge, clarkeWright et l'arbre couvrant de Kruskal trient les arêtes vers les k plus proches voisins de chaque
+ * ville puis les ajoutent tant qu'elles relient deux ensembles différents d'un union-find.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "../map.h"
+#include "edges.h"
+
+/**
+ * \fn Edge* edgesFromNeighbours(Map m, int except, size_t *nbEdges)
+ * \brief Fonction qui retourne les arêtes entre chaque ville et ses plus proches voisins, chacune une seule fois.
+ * \param Map m : Map des villes, dont les listes de voisins sont calculées.
+ * \param int except : Ville dont les arêtes sont écartées (-1 pour aucune).
+ * \param size_t *nbEdges : Rempli avec le nombre d'arêtes.
+ * \return Un tableau de *nbEdges arêtes (au plus nk), de poids leur longueur, non trié.
+ */
+
+Edge* edgesFromNeighbours(Map m, int except, size_t *nbEdges)
+{
+    int nbCities=mapGetSize(m);
+    int k=mapGetNbNeighbours(m);
+    Edge *edges=malloc((size_t)nbCities*k*sizeof(Edge));
+    size_t nb=0;
+
+    for(int i=0; i<nbCities; i++)
+    {
+        if(i==except)
+            continue;
+
+        const int *nbi=mapGetNeighbours(m, i);
+
+        for(int l=0; l<k; l++)
+        {
+            int j=nbi[l];
+            const int *nbj=mapGetNeighbours(m, j);
+            bool twice=false; // arête déjà donnée par la liste de j
+
+            if(j==except)
+                continue;
+
+            if(j<i)
+                for(int q=0; q<k && !twice; q++)
+                    twice=nbj[q]==i;
+
+            if(!twice)
+            {
+                edges[nb].w=mapDist(m, i, j);
+                edges[nb].u=i<j ? i : j;
+                edges[nb].v=i<j ? j : i;
+                nb++;
+            }
+        }
+    }
+
+    *nbEdges=nb;
+    return edges;
+}
+
+/**
+ * \fn int edgesCompare(const void *a, const void *b)
+ * \brief Fonction de comparaison de qsort : arêtes par poids croissant, puis par indices.
+ */
+
+int edgesCompare(const void *a, const void *b)
+{
+    const Edge *ea=a, *eb=b;
+
+    if(ea->w!=eb->w)
+        return ea->w<eb->w ? -1 : 1;
+    if(ea->u!=eb->u)
+        return ea->u-eb->u;
+    return ea->v-eb->v;
+}
+
+/**
+ * \fn int edgesFind(int *set, int i)
+ * \brief Fonction qui retourne le représentant de l'ensemble de i (union-find), en compressant le chemin parcouru.
+ * \param int *set : Père de chaque ville dans la forêt de l'union-find (set[r]==r pour un représentant).
+ * \param int i : Ville.
+ * \return Le représentant de l'ensemble de i.
+ */
+
+int edgesFind(int *set, int i)
+{
+    int r=i;
+
+    while(set[r]!=r)
+        r=set[r];
+
+    while(set[i]!=r)
+    {
+        int next=set[i];
+        set[i]=r;
+        i=next;
+    }
+
+    return r;
+}
@@ -0,0 +1,56 @@
+/**
+ * \file edges.h
+ * \brief Fichier d'en-tête des outils communs aux algorithmes sur les arêtes vers les plus proches voisins.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef EDGES_H_INCLUDED
+#define EDGES_H_INCLUDED
+
+#include <stddef.h>
+
+#include "../map.h"
+
+/**
+ * \struct Edge
+ * \brief Arête candidate.
+ */
+
+typedef struct
+{
+    double w; /*!< Poids de l'arête, par lequel elle est triée (sa longueur à la création). */
+    int u; /*!< Plus petit indice des deux villes. */
+    int v; /*!< Plus grand indice des deux villes. */
+} Edge;
+
+/**
+ * \fn Edge* edgesFromNeighbours(Map m, int except, size_t *nbEdges)
+ * \brief Fonction qui retourne les arêtes entre chaque ville et ses plus proches voisins, chacune une seule fois.
+ * \param Map m : Map des villes, dont les listes de voisins sont calculées.
+ * \param int except : Ville dont les arêtes sont écartées (-1 pour aucune).
+ * \param size_t *nbEdges : Rempli avec le nombre d'arêtes.
+ * \return Un tableau de *nbEdges arêtes (au plus nk), de poids leur longueur, non trié.
+ */
+
+Edge* edgesFromNeighbours(Map m, int except, size_t *nbEdges);
+
+/**
+ * \fn int edgesCompare(const void *a, const void *b)
+ * \brief Fonction de comparaison de qsort : arêtes par poids croissant, puis par indices.
+ */
+
+int edgesCompare(const void *a, const void *b);
+
+/**
+ * \fn int edgesFind(int *set, int i)
+ * \brief Fonction qui retourne le représentant de l'ensemble de i (union-find), en compressant le chemin parcouru.
+ * \param int *set : Père de chaque ville dans la forêt de l'union-find (set[r]==r pour un représentant).
+ * \param int i : Ville.
+ * \return Le représentant de l'ensemble de i.
+ */
+
+int edgesFind(int *set, int i);
+
+#endif // EDGES_H_INCLUDED
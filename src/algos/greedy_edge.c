@@ -0,0 +1,279 @@
+/**
+ * \file greedy_edge.c
+ * \brief Fichier implémentant l'algorithme glouton sur les arêtes (multi-fragment).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Les arêtes vers les plus proches voisins de chaque ville sont triées par longueur, puis ajoutées tant qu'elles ne
+ * donnent pas un degré 3 à une ville ni ne ferment un cycle (union-find, voir edges.h) : O(nk log n). Les chemins
+ * (fragments) obtenus sont ensuite reliés par leurs extrémités, en allant à chaque fois vers l'extrémité libre la plus
+ * proche (arbre k-d sur une Map de points sans matrice), puis le dernier est refermé sur le premier.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "../city.h"
+#include "../point.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "kdtree.h"
+#include "edges.h"
+#include "greedy_edge.h"
+
+/**
+ * \def GREEDY_NEIGHBOURS
+ * \brief Nombre de plus proches voisins par ville dont les arêtes sont candidates, si la Map n'a pas déjà des listes de voisins.
+ */
+
+#define GREEDY_NEIGHBOURS 10
+
+/**
+ * \fn void greedyLink(int *adj, int *degree, int u, int v)
+ * \brief Fonction qui ajoute l'arête (u, v) aux deux voisins au plus de chaque ville.
+ * \param int *adj : Voisins de chaque ville (2 cases par ville).
+ * \param int *degree : Degré de chaque ville, augmenté pour u et v.
+ * \param int u : Première ville.
+ * \param int v : Deuxième ville.
+ * \return void
+ */
+
+void greedyLink(int *adj, int *degree, int u, int v)
+{
+    adj[2*u+degree[u]++]=v;
+    adj[2*v+degree[v]++]=u;
+}
+
+/**
+ * \fn void greedyJoinFragments(Map m, int *adj, int *degree, int start)
+ * \brief Fonction qui relie les fragments en un cycle, en allant de l'extrémité courante à l'extrémité libre la plus proche.
+ * \param Map m : Map des villes.
+ * \param int *adj : Voisins de chaque ville (2 cases par ville), complétés.
+ * \param int *degree : Degré de chaque ville, complété.
+ * \param int start : Ville dont le fragment est parcouru en premier.
+ * \return void
+ */
+
+void greedyJoinFragments(Map m, int *adj, int *degree, int start)
+{
+    int nbCities=mapGetSize(m);
+    int *ends=malloc(nbCities*sizeof(int)); // extrémités des fragments (une seule pour une ville isolée)
+    int *other=malloc(nbCities*sizeof(int)); // autre extrémité du fragment de chaque extrémité
+    int *endIndex=malloc(nbCities*sizeof(int)); // position de chaque extrémité dans ends
+    int nbEnds=0;
+
+    for(int i=0; i<nbCities; i++)
+        if(degree[i]<2)
+        {
+            endIndex[i]=nbEnds;
+            ends[nbEnds++]=i;
+            other[i]=-1;
+        }
+
+    for(int e=0; e<nbEnds; e++) // parcours de chaque fragment depuis une extrémité jusqu'à l'autre
+    {
+        int a=ends[e];
+
+        if(degree[a]==0)
+            other[a]=a;
+
+        if(other[a]>=0) // ville isolée, ou autre extrémité d'un fragment déjà parcouru
+            continue;
+
+        int prev=a, cur=adj[2*a];
+
+        while(degree[cur]==2)
+        {
+            int next=adj[2*cur]!=prev ? adj[2*cur] : adj[2*cur+1];
+            prev=cur;
+            cur=next;
+        }
+
+        other[a]=cur;
+        other[cur]=a;
+    }
+
+    // fragment de départ : start ou, s'il est au milieu d'un fragment, une extrémité de son fragment
+    int first=start;
+
+    if(degree[start]==2)
+    {
+        int prev=start, cur=adj[2*start];
+
+        while(degree[cur]==2)
+        {
+            int next=adj[2*cur]!=prev ? adj[2*cur] : adj[2*cur+1];
+            prev=cur;
+            cur=next;
+        }
+
+        first=cur;
+    }
+
+    const double *xs=mapGetXs(m);
+    const double *ys=mapGetYs(m);
+    bool useTree=xs && kdSupports(mapGetLengthType(m));
+    bool *used=calloc(nbEnds, sizeof(bool));
+    KdTree t=NULL;
+    double *px=NULL, *py=NULL;
+
+    if(useTree)
+    {
+        px=malloc(nbEnds*sizeof(double));
+        py=malloc(nbEnds*sizeof(double));
+
+        for(int e=0; e<nbEnds; e++)
+        {
+            px[e]=xs[ends[e]];
+            py[e]=ys[ends[e]];
+        }
+
+        t=kdCreate(px, py, nbEnds, mapGetLengthType(m));
+    }
+
+    int cur=other[first];
+
+    used[endIndex[first]]=true;
+    used[endIndex[cur]]=true;
+
+    if(useTree)
+    {
+        kdRemove(t, endIndex[first]);
+        if(cur!=first)
+            kdRemove(t, endIndex[cur]);
+    }
+
+    for(int nbLeft=nbEnds-(cur==first ? 1 : 2); nbLeft>0; )
+    {
+        int best=-1;
+
+        if(useTree)
+        {
+            Point p={xs[cur], ys[cur]};
+            best=kdNearest(t, p);
+        }
+        else
+        {
+            double minDist=0;
+
+            for(int e=0; e<nbEnds; e++)
+                if(!used[e] && (best<0 || mapDist(m, cur, ends[e])<minDist))
+                {
+                    minDist=mapDist(m, cur, ends[e]);
+                    best=e;
+                }
+        }
+
+        int a=ends[best], b=other[a];
+
+        used[best]=true;
+        used[endIndex[b]]=true;
+        nbLeft-=a==b ? 1 : 2;
+
+        if(useTree)
+        {
+            kdRemove(t, best);
+            if(a!=b)
+                kdRemove(t, endIndex[b]);
+        }
+
+        greedyLink(adj, degree, cur, a);
+        cur=b;
+    }
+
+    greedyLink(adj, degree, cur, first);
+
+    if(useTree)
+    {
+        kdDelete(t);
+        free(py);
+        free(px);
+    }
+
+    free(used);
+    free(endIndex);
+    free(other);
+    free(ends);
+}
+
+/**
+ * \fn City* greedyEdge(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme glouton sur les arêtes (multi-fragment).
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* greedyEdge(Map m, City c)
+{
+    int nbCities=mapGetSize(m);
+    City *path=arrCitiesCreate(nbCities+1);
+    int start=cityGetIndex(c);
+
+    if(nbCities<3)
+    {
+        for(int i=0; i<nbCities; i++)
+            path[i]=mapGetCity(m, (start+i)%nbCities);
+        path[nbCities]=c;
+        return path;
+    }
+
+    if(mapGetNbNeighbours(m)==0)
+        mapBuildNeighbours(m, GREEDY_NEIGHBOURS);
+
+    size_t nbEdges;
+    Edge *edges=edgesFromNeighbours(m, -1, &nbEdges);
+
+    qsort(edges, nbEdges, sizeof(Edge), edgesCompare);
+
+    int *set=malloc(nbCities*sizeof(int));
+    int *adj=malloc(2*nbCities*sizeof(int));
+    int *degree=calloc(nbCities, sizeof(int));
+    int nbAdded=0;
+
+    for(int i=0; i<nbCities; i++)
+        set[i]=i;
+
+    for(size_t e=0; e<nbEdges && nbAdded<nbCities-1; e++)
+    {
+        int u=edges[e].u, v=edges[e].v;
+
+        if(degree[u]==2 || degree[v]==2)
+            continue;
+
+        int ru=edgesFind(set, u);
+        int rv=edgesFind(set, v);
+
+        if(ru==rv)
+            continue;
+
+        set[ru]=rv;
+        greedyLink(adj, degree, u, v);
+        nbAdded++;
+    }
+
+    free(edges);
+    free(set);
+
+    greedyJoinFragments(m, adj, degree, start);
+
+    int prev=adj[2*start+1], cur=start;
+
+    for(int i=0; i<nbCities; i++)
+    {
+        int next=adj[2*cur]!=prev ? adj[2*cur] : adj[2*cur+1];
+
+        path[i]=mapGetCity(m, cur);
+        prev=cur;
+        cur=next;
+    }
+
+    path[nbCities]=c;
+
+    free(degree);
+    free(adj);
+
+    return path;
+}
@@ -0,0 +1,49 @@
+/**
+ * \file greedy_edge.h
+ * \brief Fichier d'en-tête de l'algorithme glouton sur les arêtes (multi-fragment).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef GREEDY_EDGE_H_INCLUDED
+#define GREEDY_EDGE_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn void greedyLink(int *adj, int *degree, int u, int v)
+ * \brief Fonction qui ajoute l'arête (u, v) aux deux voisins au plus de chaque ville.
+ * \param int *adj : Voisins de chaque ville (2 cases par ville).
+ * \param int *degree : Degré de chaque ville, augmenté pour u et v.
+ * \param int u : Première ville.
+ * \param int v : Deuxième ville.
+ * \return void
+ */
+
+void greedyLink(int *adj, int *degree, int u, int v);
+
+/**
+ * \fn void greedyJoinFragments(Map m, int *adj, int *degree, int start)
+ * \brief Fonction qui relie des fragments (chemins disjoints couvrant toutes les villes) en un cycle, en allant de l'extrémité courante à l'extrémité libre la plus proche.
+ * \param Map m : Map des villes.
+ * \param int *adj : Voisins de chaque ville (2 cases par ville, les degree[i] premières remplies), complétés.
+ * \param int *degree : Degré de chaque ville (0, 1 ou 2), complété : toutes les villes sont de degré 2 à la fin.
+ * \param int start : Ville dont le fragment est parcouru en premier.
+ * \return void
+ */
+
+void greedyJoinFragments(Map m, int *adj, int *degree, int start);
+
+/**
+ * \fn City* greedyEdge(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme glouton sur les arêtes (multi-fragment).
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* greedyEdge(Map m, City c);
+
+#endif // GREEDY_EDGE_H_INCLUDED
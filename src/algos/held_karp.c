@@ -0,0 +1,222 @@
+/**
+ * \file held_karp.c
+ * \brief Fichier implémentant l'algorithme exact de Held et Karp (programmation dynamique sur les sous-ensembles).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Pour chaque sous-ensemble S des k = n-1 autres villes et chaque ville j de S, cost[S][j] est la longueur du plus court
+ * chemin qui part de la ville de départ, passe par toutes les villes de S et finit en j :
+ * cost[S][j] = min sur i de S - {j} de cost[S - {j}][i] + d(i, j). Le tableau est rangé par sous-ensemble (les k cases
+ * d'un sous-ensemble se suivent), avec des longueurs en float et le prédécesseur de j sur un octet : 5 k 2^k octets.
+ * Les sous-ensembles d'une même taille ne dépendent que de ceux de la taille précédente : ils sont répartis entre
+ * getNbThreads() threads, par blocs de HELD_KARP_BLOCK sous-ensembles.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "../city.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "held_karp.h"
+
+/**
+ * \def HELD_KARP_MAX_CITIES
+ * \brief Nombre maximum de villes (les sous-ensembles tiennent sur 32 bits).
+ */
+
+#define HELD_KARP_MAX_CITIES 30
+
+/**
+ * \def HELD_KARP_BLOCK
+ * \brief Nombre de sous-ensembles consécutifs traités par un thread avant de passer aux suivants.
+ */
+
+#define HELD_KARP_BLOCK 4096
+
+/** \struct hk_params
+ *  \brief Paramètres d'un thread de heldKarp : il traite les sous-ensembles de taille size des blocs first, first+step...
+ */
+
+struct hk_params
+{
+    int k; /*!< Nombre de villes autres que la ville de départ. */
+    int size; /*!< Taille des sous-ensembles traités. */
+    int first; /*!< Premier bloc du thread. */
+    int step; /*!< Écart entre deux blocs du thread (nombre de threads). */
+    const float *dist; /*!< Distances entre les k villes (k*k). */
+    float *cost; /*!< Longueurs des plus courts chemins, k cases par sous-ensemble. */
+    uint8_t *pred; /*!< Avant-dernière ville de ces chemins, k cases par sous-ensemble. */
+};
+
+/**
+ * \fn static void *hk_thread(void *arg)
+ * \brief Fonction appelée par pthread : calcule cost et pred pour les sous-ensembles de taille size des blocs du thread.
+ */
+
+static void *hk_thread(void *arg)
+{
+    struct hk_params *param=arg;
+    int k=param->k;
+    uint32_t nbSubsets=(uint32_t)1<<k;
+
+    for(uint64_t block=(uint64_t)param->first*HELD_KARP_BLOCK; block<nbSubsets; block+=(uint64_t)param->step*HELD_KARP_BLOCK)
+    {
+        uint32_t end=block+HELD_KARP_BLOCK<nbSubsets ? block+HELD_KARP_BLOCK : nbSubsets;
+
+        for(uint32_t s=block; s<end; s++)
+        {
+            if(__builtin_popcount(s)!=param->size)
+                continue;
+
+            for(uint32_t inS=s; inS; inS&=inS-1)
+            {
+                int j=__builtin_ctz(inS);
+                uint32_t prev=s&~((uint32_t)1<<j);
+                const float *prevCost=param->cost+(size_t)prev*k;
+                const float *toJ=param->dist+(size_t)j*k;
+                float best=INFINITY;
+                int bestI=0;
+
+                for(uint32_t rest=prev; rest; rest&=rest-1) // villes i de prev, par bit de poids faible
+                {
+                    int i=__builtin_ctz(rest);
+
+                    if(prevCost[i]+toJ[i]<best)
+                    {
+                        best=prevCost[i]+toJ[i];
+                        bestI=i;
+                    }
+                }
+
+                param->cost[(size_t)s*k+j]=best;
+                param->pred[(size_t)s*k+j]=bestI;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \fn City* heldKarp(Map m, City c)
+ * \brief Fonction qui calcule un chemin optimal par la programmation dynamique de Held et Karp, en O(n² 2^n).
+ * \param Map m : Map à laquelle est appliqué l'algorithme (au plus HELD_KARP_MAX_CITIES villes, et assez de mémoire).
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* heldKarp(Map m, City c)
+{
+    int nbCities=mapGetSize(m);
+    int start=cityGetIndex(c);
+    int k=nbCities-1;
+    City *path=arrCitiesCreate(nbCities+1);
+
+    if(nbCities>HELD_KARP_MAX_CITIES)
+        throwErr("HeldKarp", "Too many cities for heldKarp (maximum 30)", mapGetName(m));
+
+    size_t nbSubsets=(size_t)1<<k;
+    size_t needed=nbSubsets*k*(sizeof(float)+sizeof(uint8_t));
+    size_t available=getAvailableMemory();
+
+    if(available>0 && needed>available)
+        throwErr("HeldKarp", "Not enough memory for heldKarp (5 n 2^n bytes)", mapGetName(m));
+
+    if(k<2)
+    {
+        for(int i=0; i<nbCities; i++)
+            path[i]=mapGetCity(m, (start+i)%nbCities);
+        path[nbCities]=c;
+        return path;
+    }
+
+    int *cities=malloc(k*sizeof(int)); // villes autres que la ville de départ
+    float *dist=malloc((size_t)k*k*sizeof(float)); // dist[j*k+i] : de i à j
+    float *cost=malloc(nbSubsets*k*sizeof(float));
+    uint8_t *pred=malloc(nbSubsets*k*sizeof(uint8_t));
+
+    if(!cost || !pred)
+        throwErr("HeldKarp", "Not enough memory for heldKarp (5 n 2^n bytes)", mapGetName(m));
+
+    for(int i=0, j=0; i<nbCities; i++)
+        if(i!=start)
+            cities[j++]=i;
+
+    for(int j=0; j<k; j++)
+    {
+        for(int i=0; i<k; i++)
+            dist[j*k+i]=mapDist(m, cities[i], cities[j]);
+
+        cost[((size_t)1<<j)*k+j]=mapDist(m, start, cities[j]);
+        pred[((size_t)1<<j)*k+j]=j;
+    }
+
+    int nbThreads=getNbThreads();
+    int nbBlocks=(nbSubsets+HELD_KARP_BLOCK-1)/HELD_KARP_BLOCK;
+
+    if(nbThreads>nbBlocks)
+        nbThreads=nbBlocks;
+
+    pthread_t thread[nbThreads];
+    struct hk_params params[nbThreads];
+
+    for(int t=0; t<nbThreads; t++)
+    {
+        params[t].k=k;
+        params[t].first=t;
+        params[t].step=nbThreads;
+        params[t].dist=dist;
+        params[t].cost=cost;
+        params[t].pred=pred;
+    }
+
+    for(int size=2; size<=k; size++) // les sous-ensembles de taille size ne lisent que ceux de taille size-1
+    {
+        for(int t=0; t<nbThreads; t++)
+            params[t].size=size;
+
+        for(int t=1; t<nbThreads; t++)
+            pthread_create(&thread[t], NULL, hk_thread, &params[t]);
+
+        hk_thread(&params[0]);
+
+        for(int t=1; t<nbThreads; t++)
+            pthread_join(thread[t], NULL);
+    }
+
+    // fermeture du cycle, puis remontée des prédécesseurs depuis l'ensemble complet
+    uint32_t s=(uint32_t)(nbSubsets-1);
+    float best=INFINITY;
+    int last=0;
+
+    for(int j=0; j<k; j++)
+        if(cost[(size_t)s*k+j]+mapDist(m, cities[j], start)<best)
+        {
+            best=cost[(size_t)s*k+j]+mapDist(m, cities[j], start);
+            last=j;
+        }
+
+    path[0]=c;
+    path[nbCities]=c;
+
+    for(int pos=k; pos>=1; pos--)
+    {
+        int before=pred[(size_t)s*k+last];
+
+        path[pos]=mapGetCity(m, cities[last]);
+        s&=~((uint32_t)1<<last);
+        last=before;
+    }
+
+    free(pred);
+    free(cost);
+    free(dist);
+    free(cities);
+
+    return path;
+}
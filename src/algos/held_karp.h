@@ -0,0 +1,25 @@
+/**
+ * \file held_karp.h
+ * \brief Fichier d'en-tête de l'algorithme exact de Held et Karp (programmation dynamique sur les sous-ensembles).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef HELD_KARP_H_INCLUDED
+#define HELD_KARP_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn City* heldKarp(Map m, City c)
+ * \brief Fonction qui calcule un chemin optimal par la programmation dynamique de Held et Karp, en O(n² 2^n).
+ * \param Map m : Map à laquelle est appliqué l'algorithme (au plus HELD_KARP_MAX_CITIES villes, et assez de mémoire).
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* heldKarp(Map m, City c);
+
+#endif // HELD_KARP_H_INCLUDED
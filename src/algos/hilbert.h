@@ -0,0 +1,25 @@
+/**
+ * \file hilbert.h
+ * \brief Fichier d'en-tête de l'algorithme de la courbe de Hilbert.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef HILBERT_H_INCLUDED
+#define HILBERT_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn City* hilbertCurve(Map m, City c)
+ * \brief Fonction qui parcourt les villes dans l'ordre de la courbe de Hilbert (Map de points uniquement).
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* hilbertCurve(Map m, City c);
+
+#endif // HILBERT_H_INCLUDED
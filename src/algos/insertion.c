@@ -0,0 +1,491 @@
+/**
+ * \file insertion.c
+ * \brief Fichier implémentant les algorithmes d'insertion (plus proche, plus lointaine, moins chère, enveloppe convexe).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Le chemin partiel est une liste chaînée (ville suivante et longueur de l'arête vers elle). Une ville est toujours
+ * insérée sur l'arête (a, b) qui minimise d(a, c) + d(c, b) - d(a, b) ; seul le choix de la ville change :
+ * - plus proche / plus lointaine : la distance de chaque ville restante au chemin est mise à jour après chaque
+ *   insertion avec une ligne de distances, O(n²) ;
+ * - moins chère / enveloppe convexe : chaque ville restante garde sa meilleure arête d'insertion et la clé qui en
+ *   découle (coût, ou rapport (d(a, c) + d(c, b)) / d(a, b) pour l'enveloppe convexe). Après l'insertion de u entre a
+ *   et b, seules les deux nouvelles arêtes sont essayées pour chaque ville. Si la meilleure arête d'une ville était
+ *   (a, b) et qu'aucune nouvelle arête ne la vaut, son ancien coût reste un minorant et elle n'est recalculée que si elle
+ *   arrive en tête (l'enveloppe convexe, rangée par rapport, la recalcule tout de suite) : O(n²) en pratique au lieu de
+ *   O(n³).
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "../city.h"
+#include "../point.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "insertion.h"
+
+/** \struct InsTour
+ *  \brief Chemin partiel d'un algorithme d'insertion.
+ */
+
+typedef struct
+{
+    Map m; /*!< Map des villes. */
+    int n; /*!< Nombre de villes de la Map. */
+    int size; /*!< Nombre de villes du chemin. */
+    int *next; /*!< Ville suivante dans le chemin (villes du chemin seulement). */
+    double *len; /*!< Longueur de l'arête (i, next[i]). */
+    bool *in; /*!< Villes du chemin. */
+} InsTour;
+
+/**
+ * \fn static void insInit(InsTour *t, Map m, int first)
+ * \brief Fonction qui crée un chemin réduit à la ville first.
+ */
+
+static void insInit(InsTour *t, Map m, int first)
+{
+    t->m=m;
+    t->n=mapGetSize(m);
+    t->size=1;
+    t->next=malloc(t->n*sizeof(int));
+    t->len=malloc(t->n*sizeof(double));
+    t->in=calloc(t->n, sizeof(bool));
+    t->next[first]=first;
+    t->len[first]=0;
+    t->in[first]=true;
+}
+
+/**
+ * \fn static void insInsert(InsTour *t, int a, int u)
+ * \brief Fonction qui insère la ville u entre a et sa suivante.
+ */
+
+static void insInsert(InsTour *t, int a, int u)
+{
+    int b=t->next[a];
+
+    t->next[u]=b;
+    t->len[u]=mapDist(t->m, u, b);
+    t->next[a]=u;
+    t->len[a]=mapDist(t->m, a, u);
+    t->in[u]=true;
+    t->size++;
+}
+
+/**
+ * \fn static double insBestEdge(InsTour *t, int u, const double *row, int *best)
+ * \brief Fonction qui cherche l'arête du chemin où insérer u coûte le moins.
+ * \param const double *row : Distances de u à toutes les villes, ou NULL pour les calculer.
+ * \param int *best : Rempli avec la première ville de l'arête.
+ * \return Le coût de l'insertion.
+ */
+
+static double insBestEdge(InsTour *t, int u, const double *row, int *best)
+{
+    int first=0;
+
+    while(!t->in[first])
+        first++;
+
+    double minCost=INFINITY;
+    int a=first;
+    double dua=row ? row[a] : mapDist(t->m, u, a);
+
+    do
+    {
+        int b=t->next[a];
+        double dub=row ? row[b] : mapDist(t->m, u, b);
+        double cost=dua+dub-t->len[a];
+
+        if(cost<minCost)
+        {
+            minCost=cost;
+            *best=a;
+        }
+
+        a=b;
+        dua=dub;
+    } while(a!=first);
+
+    return minCost;
+}
+
+/**
+ * \fn static City* insToPath(InsTour *t, City c)
+ * \brief Fonction qui écrit le chemin complet sous forme de tableau de City en partant de c, puis libère le chemin partiel.
+ */
+
+static City* insToPath(InsTour *t, City c)
+{
+    City *path=arrCitiesCreate(t->n+1);
+    int a=cityGetIndex(c);
+
+    for(int i=0; i<t->n; i++)
+    {
+        path[i]=mapGetCity(t->m, a);
+        a=t->next[a];
+    }
+
+    path[t->n]=c;
+
+    free(t->in);
+    free(t->len);
+    free(t->next);
+
+    return path;
+}
+
+/**
+ * \fn static City* insDistanceOrder(Map m, City c, bool farthest)
+ * \brief Fonction qui insère à chaque étape la ville la plus proche (ou la plus éloignée) du chemin.
+ */
+
+static City* insDistanceOrder(Map m, City c, bool farthest)
+{
+    int n=mapGetSize(m);
+    int start=cityGetIndex(c);
+    InsTour t;
+    double *row=malloc(n*sizeof(double));
+    double *dist=malloc(n*sizeof(double)); // distance de chaque ville restante au chemin
+    int *rest=malloc(n*sizeof(int));
+    int nbRest=0;
+
+    insInit(&t, m, start);
+    mapDistsFrom(m, start, row);
+
+    for(int i=0; i<n; i++)
+        if(i!=start)
+        {
+            rest[nbRest++]=i;
+            dist[i]=row[i];
+        }
+
+    while(nbRest>0)
+    {
+        int r=0;
+
+        for(int i=1; i<nbRest; i++)
+            if(farthest ? dist[rest[i]]>dist[rest[r]] : dist[rest[i]]<dist[rest[r]])
+                r=i;
+
+        int u=rest[r];
+        int a=start;
+
+        rest[r]=rest[--nbRest];
+        mapDistsFrom(m, u, row);
+        insBestEdge(&t, u, row, &a);
+        insInsert(&t, a, u);
+
+        for(int i=0; i<nbRest; i++)
+            if(row[rest[i]]<dist[rest[i]])
+                dist[rest[i]]=row[rest[i]];
+    }
+
+    free(rest);
+    free(dist);
+    free(row);
+
+    return insToPath(&t, c);
+}
+
+/**
+ * \fn City* nearestInsertion(Map m, City c)
+ * \brief Fonction qui insère à chaque étape la ville la plus proche du chemin, là où elle l'allonge le moins.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* nearestInsertion(Map m, City c)
+{
+    return insDistanceOrder(m, c, false);
+}
+
+/**
+ * \fn City* farthestInsertion(Map m, City c)
+ * \brief Fonction qui insère à chaque étape la ville la plus éloignée du chemin, là où elle l'allonge le moins.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* farthestInsertion(Map m, City c)
+{
+    return insDistanceOrder(m, c, true);
+}
+
+/**
+ * \fn static double insKey(InsTour *t, int a, double cost, bool ratio)
+ * \brief Fonction qui retourne la valeur comparée entre les villes restantes pour une ville dont la meilleure insertion, après a, coûte cost : le coût, ou le rapport (d(a, x) + d(x, b)) / d(a, b).
+ */
+
+static double insKey(InsTour *t, int a, double cost, bool ratio)
+{
+    if(!ratio)
+        return cost;
+
+    if(t->len[a]>0)
+        return (cost+t->len[a])/t->len[a];
+
+    return cost>0 ? INFINITY : 1;
+}
+
+/**
+ * \fn static void insCheapest(InsTour *t, bool ratio)
+ * \brief Fonction qui complète le chemin en insérant à chaque étape la ville de plus petit coût (ou rapport) d'insertion.
+ * \param InsTour *t : Chemin partiel, complété.
+ * \param bool ratio : true pour choisir la ville par rapport d'insertion (enveloppe convexe), false par coût.
+ * \return void
+ */
+
+static void insCheapest(InsTour *t, bool ratio)
+{
+    int n=t->n;
+    int *rest=malloc(n*sizeof(int));
+    int *bestA=malloc(n*sizeof(int)); // meilleure arête d'insertion (bestA, bestB) de chaque ville restante
+    int *bestB=malloc(n*sizeof(int));
+    double *bestCost=malloc(n*sizeof(double));
+    double *key=malloc(n*sizeof(double));
+    bool *stale=calloc(n, sizeof(bool)); // bestCost n'est qu'un minorant : la meilleure arête a été retirée
+    double *row=malloc(n*sizeof(double));
+    int nbRest=0;
+
+    for(int v=0; v<n; v++)
+        if(!t->in[v])
+        {
+            rest[nbRest++]=v;
+            bestCost[v]=insBestEdge(t, v, NULL, &bestA[v]);
+            bestB[v]=t->next[bestA[v]];
+            key[v]=insKey(t, bestA[v], bestCost[v], ratio);
+        }
+
+    while(nbRest>0)
+    {
+        int r=0; // position dans rest de la prochaine ville insérée
+
+        for(int i=1; i<nbRest; i++)
+            if(key[rest[i]]<key[rest[r]])
+                r=i;
+
+        if(stale[rest[r]]) // minorant en tête : la ville est recalculée et la recherche reprise
+        {
+            int v=rest[r];
+
+            bestCost[v]=insBestEdge(t, v, NULL, &bestA[v]);
+            bestB[v]=t->next[bestA[v]];
+            key[v]=bestCost[v];
+            stale[v]=false;
+            continue;
+        }
+
+        int u=rest[r];
+        int a=bestA[u], b=bestB[u];
+
+        rest[r]=rest[--nbRest];
+        insInsert(t, a, u);
+        mapDistsFrom(t->m, u, row);
+
+        for(int i=0; i<nbRest; i++)
+        {
+            int v=rest[i];
+            bool removed=!stale[v] && bestA[v]==a && bestB[v]==b;
+            double costAU=mapDist(t->m, v, a)+row[v]-t->len[a];
+            double costUB=row[v]+mapDist(t->m, v, b)-t->len[u];
+            double cost=costAU<=costUB ? costAU : costUB;
+
+            // les autres arêtes coûtent au moins bestCost : une nouvelle arête moins chère est la meilleure
+            if(cost<bestCost[v] || (removed && cost<=bestCost[v]))
+            {
+                bestA[v]=costAU<=costUB ? a : u;
+                bestB[v]=costAU<=costUB ? u : b;
+                bestCost[v]=cost;
+                key[v]=insKey(t, bestA[v], cost, ratio);
+                stale[v]=false;
+            }
+            else if(removed)
+            {
+                if(ratio) // le rapport n'a pas de minorant : recalcul
+                {
+                    bestCost[v]=insBestEdge(t, v, NULL, &bestA[v]);
+                    bestB[v]=t->next[bestA[v]];
+                    key[v]=insKey(t, bestA[v], bestCost[v], ratio);
+                }
+                else
+                    stale[v]=true;
+            }
+        }
+    }
+
+    free(row);
+    free(stale);
+    free(key);
+    free(bestCost);
+    free(bestB);
+    free(bestA);
+    free(rest);
+}
+
+/**
+ * \fn City* cheapestInsertion(Map m, City c)
+ * \brief Fonction qui insère à chaque étape la ville qui allonge le moins le chemin.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* cheapestInsertion(Map m, City c)
+{
+    InsTour t;
+
+    insInit(&t, m, cityGetIndex(c));
+    insCheapest(&t, false);
+
+    return insToPath(&t, c);
+}
+
+/** \struct InsPoint
+ *  \brief Ville et ses coordonnées, pour le calcul de l'enveloppe convexe.
+ */
+
+typedef struct
+{
+    double x; /*!< Abscisse. */
+    double y; /*!< Ordonnée. */
+    int i; /*!< Indice de la ville. */
+} InsPoint;
+
+/**
+ * \fn static int insComparePoints(const void *a, const void *b)
+ * \brief Fonction de comparaison de qsort : points par abscisse, puis ordonnée, puis indice.
+ */
+
+static int insComparePoints(const void *a, const void *b)
+{
+    const InsPoint *pa=a, *pb=b;
+
+    if(pa->x!=pb->x)
+        return pa->x<pb->x ? -1 : 1;
+    if(pa->y!=pb->y)
+        return pa->y<pb->y ? -1 : 1;
+    return pa->i-pb->i;
+}
+
+/**
+ * \fn static double insCross(const InsPoint *o, const InsPoint *a, const InsPoint *b)
+ * \brief Fonction qui retourne le produit vectoriel de oa et ob (positif si o, a, b tournent à gauche).
+ */
+
+static double insCross(const InsPoint *o, const InsPoint *a, const InsPoint *b)
+{
+    return (a->x-o->x)*(b->y-o->y)-(a->y-o->y)*(b->x-o->x);
+}
+
+/**
+ * \fn static int insConvexHull(Map m, int *hull)
+ * \brief Fonction qui calcule l'enveloppe convexe des villes (parcours monotone d'Andrew, O(n log n)).
+ * \param int *hull : Rempli avec les villes de l'enveloppe dans l'ordre trigonométrique (mapGetSize(m) cases).
+ * \return Le nombre de villes de l'enveloppe, 0 si les villes n'ont pas de coordonnées.
+ */
+
+static int insConvexHull(Map m, int *hull)
+{
+    int n=mapGetSize(m);
+    const double *xs=mapGetXs(m);
+    const double *ys=mapGetYs(m);
+
+    if(!xs && !mapGetIsPos(m))
+        return 0;
+
+    InsPoint *pts=malloc(n*sizeof(InsPoint));
+    InsPoint **h=malloc(2*n*sizeof(InsPoint*));
+    int k=0;
+
+    for(int i=0; i<n; i++)
+    {
+        if(xs)
+        {
+            pts[i].x=xs[i];
+            pts[i].y=ys[i];
+        }
+        else
+        {
+            Point p=cityGetPos(mapGetCity(m, i));
+
+            pts[i].x=pointGetX(p);
+            pts[i].y=pointGetY(p);
+        }
+
+        pts[i].i=i;
+    }
+
+    qsort(pts, n, sizeof(InsPoint), insComparePoints);
+
+    for(int i=0; i<n; i++) // bord inférieur
+    {
+        while(k>=2 && insCross(h[k-2], h[k-1], &pts[i])<=0)
+            k--;
+        h[k++]=&pts[i];
+    }
+
+    for(int i=n-2, low=k+1; i>=0; i--) // bord supérieur
+    {
+        while(k>=low && insCross(h[k-2], h[k-1], &pts[i])<=0)
+            k--;
+        h[k++]=&pts[i];
+    }
+
+    k--; // le premier point est répété à la fin
+
+    if(k<1)
+        k=1;
+
+    for(int i=0; i<k; i++)
+        hull[i]=h[i]->i;
+
+    free(h);
+    free(pts);
+
+    return k;
+}
+
+/**
+ * \fn City* convexHullInsertion(Map m, City c)
+ * \brief Fonction qui part de l'enveloppe convexe des villes et insère à chaque étape la ville de plus petit rapport d'insertion.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ *
+ * Chaque ville restante est insérée sur son arête de plus petit coût, et la ville choisie est celle dont cette
+ * insertion a le plus petit rapport (d(a, c) + d(c, b)) / d(a, b). Sans coordonnées, le chemin part de c seule.
+ */
+
+City* convexHullInsertion(Map m, City c)
+{
+    int n=mapGetSize(m);
+    int *hull=malloc(n*sizeof(int));
+    int nbHull=insConvexHull(m, hull);
+    InsTour t;
+
+    if(nbHull==0)
+    {
+        throwWarn("Insertion", "Cities have no positions, starting from the start city alone (convexHullInsertion)", NULL);
+        hull[0]=cityGetIndex(c);
+        nbHull=1;
+    }
+
+    insInit(&t, m, hull[0]);
+
+    for(int i=1; i<nbHull; i++)
+        insInsert(&t, hull[i-1], hull[i]);
+
+    free(hull);
+
+    insCheapest(&t, true);
+
+    return insToPath(&t, c);
+}
@@ -0,0 +1,55 @@
+/**
+ * \file insertion.h
+ * \brief Fichier d'en-tête des algorithmes d'insertion (plus proche, plus lointaine, moins chère, enveloppe convexe).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef INSERTION_H_INCLUDED
+#define INSERTION_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn City* nearestInsertion(Map m, City c)
+ * \brief Fonction qui insère à chaque étape la ville la plus proche du chemin, là où elle l'allonge le moins.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* nearestInsertion(Map m, City c);
+
+/**
+ * \fn City* farthestInsertion(Map m, City c)
+ * \brief Fonction qui insère à chaque étape la ville la plus éloignée du chemin, là où elle l'allonge le moins.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* farthestInsertion(Map m, City c);
+
+/**
+ * \fn City* cheapestInsertion(Map m, City c)
+ * \brief Fonction qui insère à chaque étape la ville qui allonge le moins le chemin.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* cheapestInsertion(Map m, City c);
+
+/**
+ * \fn City* convexHullInsertion(Map m, City c)
+ * \brief Fonction qui part de l'enveloppe convexe des villes et insère à chaque étape la ville de plus petit rapport d'insertion.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* convexHullInsertion(Map m, City c);
+
+#endif // INSERTION_H_INCLUDED
@@ -0,0 +1,437 @@
+/**
+ * \file kdtree.c
+ * \brief Fichier implémentant l'arbre k-d (index spatial des villes en 2 dimensions).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Les points sont rangés dans un tableau permuté : chaque noeud couvre une tranche [lo, hi[ coupée en deux à la médiane
+ * de sa plus grande dimension, jusqu'à des feuilles de KD_BUCKET points. Chaque noeud garde la boîte englobante de ses
+ * points et le nombre de points restants ; un point retiré est échangé avec le dernier point restant de sa feuille, les
+ * requêtes ne parcourent donc que des points restants et sautent les sous-arbres vides.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "../point.h"
+#include "kdtree.h"
+
+/**
+ * \def KD_BUCKET
+ * \brief Nombre maximum de points d'une feuille.
+ */
+
+#define KD_BUCKET 8
+
+/**
+ * \struct KdNode
+ * \brief Noeud de l'arbre k-d.
+ */
+
+typedef struct
+{
+    int lo; /*!< Début de la tranche des points du noeud dans le tableau permuté. */
+    int hi; /*!< Fin (exclue) de la tranche. */
+    int left; /*!< Fils gauche (-1 pour une feuille). */
+    int right; /*!< Fils droit (-1 pour une feuille). */
+    int parent; /*!< Père (-1 pour la racine). */
+    int alive; /*!< Nombre de points restants dans le noeud. */
+    double minX, minY, maxX, maxY; /*!< Boîte englobante des points du noeud. */
+} KdNode;
+
+/** \struct _KdTree
+ *  \brief Structure représentant un arbre k-d.
+ */
+
+struct _KdTree
+{
+    KdNode *nodes; /*!< Noeuds, la racine en 0. */
+    int nbNodes; /*!< Nombre de noeuds. */
+    int *perm; /*!< Indices des points, rangés par feuille (les points restants en tête de chaque feuille). */
+    int *pos; /*!< Position de chaque point dans perm. */
+    int *leaf; /*!< Feuille de chaque point. */
+    double *xs; /*!< Abscisses des points dans l'ordre de perm. */
+    double *ys; /*!< Ordonnées des points dans l'ordre de perm. */
+    LengthFct lengthFct; /*!< Distance des requêtes. */
+};
+
+/**
+ * \fn bool kdSupports(int lengthType)
+ * \brief Fonction qui indique si une distance peut être indexée par l'arbre (distance croissante avec une norme du plan).
+ * \param int lengthType : Type de distance (voir point.h).
+ * \return true pour les distances euclidiennes, de manhattan et du maximum (arrondies ou non), false pour GEO.
+ *
+ * Pour ces distances, le point d'une boîte le plus proche de p est p ramené dans la boîte : sa distance à p minore celle de tous les points de la boîte.
+ */
+
+bool kdSupports(int lengthType)
+{
+    return lengthType!=GEO;
+}
+
+/**
+ * \fn static void kdSelect(KdTree t, int lo, int hi, int k, bool alongX)
+ * \brief Fonction qui place en k le point médian de la tranche [lo, hi[ selon un axe (sélection rapide).
+ * \param KdTree t : Arbre en construction.
+ * \param int lo : Début de la tranche.
+ * \param int hi : Fin (exclue) de la tranche.
+ * \param int k : Position cherchée : à gauche les points inférieurs ou égaux, à droite les supérieurs ou égaux.
+ * \param bool alongX : true pour trier selon les abscisses.
+ * \return void
+ */
+
+static void kdSelect(KdTree t, int lo, int hi, int k, bool alongX)
+{
+    double *c=alongX ? t->xs : t->ys;
+
+    hi--;
+
+    while(lo<hi)
+    {
+        double pivot=c[(lo+hi)/2];
+        int i=lo, j=hi;
+
+        while(i<=j)
+        {
+            while(c[i]<pivot)
+                i++;
+            while(c[j]>pivot)
+                j--;
+
+            if(i<=j)
+            {
+                double tmp=t->xs[i]; t->xs[i]=t->xs[j]; t->xs[j]=tmp;
+                tmp=t->ys[i]; t->ys[i]=t->ys[j]; t->ys[j]=tmp;
+                int tmpI=t->perm[i]; t->perm[i]=t->perm[j]; t->perm[j]=tmpI;
+                i++;
+                j--;
+            }
+        }
+
+        if(k<=j)
+            hi=j;
+        else if(k>=i)
+            lo=i;
+        else
+            break;
+    }
+}
+
+/**
+ * \fn static int kdBuild(KdTree t, int lo, int hi, int parent)
+ * \brief Fonction qui construit récursivement le noeud de la tranche [lo, hi[ et ses fils.
+ * \param KdTree t : Arbre en construction.
+ * \param int lo : Début de la tranche.
+ * \param int hi : Fin (exclue) de la tranche.
+ * \param int parent : Père du noeud.
+ * \return L'indice du noeud.
+ */
+
+static int kdBuild(KdTree t, int lo, int hi, int parent)
+{
+    int id=t->nbNodes++;
+    KdNode *node=&t->nodes[id];
+
+    node->lo=lo;
+    node->hi=hi;
+    node->parent=parent;
+    node->alive=hi-lo;
+    node->left=-1;
+    node->right=-1;
+    node->minX=node->maxX=t->xs[lo];
+    node->minY=node->maxY=t->ys[lo];
+
+    for(int i=lo+1; i<hi; i++)
+    {
+        node->minX=fmin(node->minX, t->xs[i]);
+        node->maxX=fmax(node->maxX, t->xs[i]);
+        node->minY=fmin(node->minY, t->ys[i]);
+        node->maxY=fmax(node->maxY, t->ys[i]);
+    }
+
+    if(hi-lo<=KD_BUCKET)
+    {
+        for(int i=lo; i<hi; i++)
+            t->leaf[t->perm[i]]=id;
+        return id;
+    }
+
+    int mid=(lo+hi)/2;
+    kdSelect(t, lo, hi, mid, node->maxX-node->minX>=node->maxY-node->minY);
+
+    node->left=kdBuild(t, lo, mid, id);
+    node->right=kdBuild(t, mid, hi, id);
+
+    return id;
+}
+
+/**
+ * \fn KdTree kdCreate(const double *xs, const double *ys, int n, int lengthType)
+ * \brief Fonction qui construit l'arbre k-d de n points.
+ * \param const double *xs : Abscisses des points.
+ * \param const double *ys : Ordonnées des points.
+ * \param int n : Nombre de points, indicés de 0 à n-1.
+ * \param int lengthType : Type de distance des requêtes (voir kdSupports).
+ * \return L'arbre, en O(n log n).
+ */
+
+KdTree kdCreate(const double *xs, const double *ys, int n, int lengthType)
+{
+    KdTree t=malloc(sizeof(struct _KdTree));
+
+    t->nodes=malloc((4*n/KD_BUCKET+1)*sizeof(KdNode)); // les feuilles ont au moins KD_BUCKET/2 points : moins de 2n/(KD_BUCKET/2) noeuds
+    t->nbNodes=0;
+    t->perm=malloc(n*sizeof(int));
+    t->pos=malloc(n*sizeof(int));
+    t->leaf=malloc(n*sizeof(int));
+    t->xs=malloc(n*sizeof(double));
+    t->ys=malloc(n*sizeof(double));
+    t->lengthFct=lengthGetFct(lengthType);
+
+    for(int i=0; i<n; i++)
+    {
+        t->perm[i]=i;
+        t->xs[i]=xs[i];
+        t->ys[i]=ys[i];
+    }
+
+    if(n>0)
+        kdBuild(t, 0, n, -1);
+
+    for(int i=0; i<n; i++)
+        t->pos[t->perm[i]]=i;
+
+    return t;
+}
+
+/**
+ * \fn void kdDelete(KdTree t)
+ * \brief Fonction qui libère un arbre k-d.
+ * \param KdTree t : Arbre à libérer.
+ * \return void
+ */
+
+void kdDelete(KdTree t)
+{
+    free(t->nodes);
+    free(t->perm);
+    free(t->pos);
+    free(t->leaf);
+    free(t->xs);
+    free(t->ys);
+    free(t);
+}
+
+/**
+ * \fn void kdRemove(KdTree t, int i)
+ * \brief Fonction qui retire le point i de l'arbre (il ne sera plus renvoyé par kdNearest).
+ * \param KdTree t : Arbre.
+ * \param int i : Indice du point, encore présent.
+ * \return void
+ *
+ * Le point est échangé avec le dernier point restant de sa feuille, puis les compteurs sont mis à jour jusqu'à la racine.
+ */
+
+void kdRemove(KdTree t, int i)
+{
+    int id=t->leaf[i];
+    KdNode *node=&t->nodes[id];
+    int p=t->pos[i];
+    int last=node->lo+node->alive-1;
+    int j=t->perm[last];
+
+    t->perm[p]=j;
+    t->perm[last]=i;
+    t->pos[j]=p;
+    t->pos[i]=last;
+
+    double tmp=t->xs[p]; t->xs[p]=t->xs[last]; t->xs[last]=tmp;
+    tmp=t->ys[p]; t->ys[p]=t->ys[last]; t->ys[last]=tmp;
+
+    for(; id>=0; id=t->nodes[id].parent)
+        t->nodes[id].alive--;
+}
+
+/**
+ * \fn static void kdSearch(KdTree t, int id, Point p, double *minDist, int *best)
+ * \brief Fonction qui cherche récursivement le point restant le plus proche de p dans le noeud id.
+ * \param KdTree t : Arbre.
+ * \param int id : Noeud parcouru.
+ * \param Point p : Point de la requête.
+ * \param double *minDist : Plus petite distance trouvée, mise à jour.
+ * \param int *best : Point le plus proche trouvé, mis à jour.
+ * \return void
+ *
+ * Le fils du côté de p est parcouru en premier ; un noeud vide ou dont la boîte est plus loin que minDist est sauté.
+ */
+
+static void kdSearch(KdTree t, int id, Point p, double *minDist, int *best)
+{
+    KdNode *node=&t->nodes[id];
+
+    if(node->alive==0)
+        return;
+
+    Point c={fmin(fmax(p.x, node->minX), node->maxX), fmin(fmax(p.y, node->minY), node->maxY)}; // point de la boîte le plus proche de p
+
+    if(*best>=0 && t->lengthFct(p, c)>*minDist)
+        return;
+
+    if(node->left<0)
+    {
+        for(int k=node->lo; k<node->lo+node->alive; k++)
+        {
+            Point q={t->xs[k], t->ys[k]};
+            double dist=t->lengthFct(p, q);
+
+            if(*best<0 || dist<*minDist || (dist==*minDist && t->perm[k]<*best))
+            {
+                *minDist=dist;
+                *best=t->perm[k];
+            }
+        }
+        return;
+    }
+
+    KdNode *left=&t->nodes[node->left];
+    KdNode *right=&t->nodes[node->right];
+
+    // le fils dont la boîte est la plus proche de p (distance le long de l'axe de coupe) est parcouru en premier
+    double dl=fmax(fmax(left->minX-p.x, p.x-left->maxX), fmax(left->minY-p.y, p.y-left->maxY));
+    double dr=fmax(fmax(right->minX-p.x, p.x-right->maxX), fmax(right->minY-p.y, p.y-right->maxY));
+
+    if(dl<=dr)
+    {
+        kdSearch(t, node->left, p, minDist, best);
+        kdSearch(t, node->right, p, minDist, best);
+    }
+    else
+    {
+        kdSearch(t, node->right, p, minDist, best);
+        kdSearch(t, node->left, p, minDist, best);
+    }
+}
+
+/**
+ * \fn int kdNearest(KdTree t, Point p)
+ * \brief Fonction qui cherche le point restant le plus proche de p.
+ * \param KdTree t : Arbre.
+ * \param Point p : Point de la requête.
+ * \return L'indice du point le plus proche (le plus petit indice en cas d'égalité), -1 si l'arbre est vide.
+ */
+
+int kdNearest(KdTree t, Point p)
+{
+    double minDist=INFINITY;
+    int best=-1;
+
+    if(t->nbNodes>0)
+        kdSearch(t, 0, p, &minDist, &best);
+
+    return best;
+}
+
+/**
+ * \fn static void kdSearchK(KdTree t, int id, Point p, int k, int except, int *nb, double *dists, int *cpt)
+ * \brief Fonction qui cherche récursivement les k points restants les plus proches de p dans le noeud id.
+ * \param KdTree t : Arbre.
+ * \param int id : Noeud parcouru.
+ * \param Point p : Point de la requête.
+ * \param int k : Nombre de points cherchés.
+ * \param int except : Point ignoré (-1 pour aucun).
+ * \param int *nb : Points trouvés, triés par distance puis par indice, mis à jour.
+ * \param double *dists : Distances des points trouvés.
+ * \param int *cpt : Nombre de points trouvés (au plus k).
+ * \return void
+ */
+
+static void kdSearchK(KdTree t, int id, Point p, int k, int except, int *nb, double *dists, int *cpt)
+{
+    KdNode *node=&t->nodes[id];
+
+    if(node->alive==0)
+        return;
+
+    Point c={fmin(fmax(p.x, node->minX), node->maxX), fmin(fmax(p.y, node->minY), node->maxY)};
+
+    if(*cpt==k && t->lengthFct(p, c)>dists[k-1])
+        return;
+
+    if(node->left<0)
+    {
+        for(int q=node->lo; q<node->lo+node->alive; q++)
+        {
+            int i=t->perm[q];
+
+            if(i==except)
+                continue;
+
+            Point pq={t->xs[q], t->ys[q]};
+            double dist=t->lengthFct(p, pq);
+
+            if(*cpt==k && (dist>dists[k-1] || (dist==dists[k-1] && i>nb[k-1])))
+                continue;
+
+            int pos=*cpt<k ? (*cpt)++ : k-1; // le plus lointain des k est remplacé
+
+            while(pos>0 && (dists[pos-1]>dist || (dists[pos-1]==dist && nb[pos-1]>i)))
+            {
+                dists[pos]=dists[pos-1];
+                nb[pos]=nb[pos-1];
+                pos--;
+            }
+
+            dists[pos]=dist;
+            nb[pos]=i;
+        }
+        return;
+    }
+
+    KdNode *left=&t->nodes[node->left];
+    KdNode *right=&t->nodes[node->right];
+
+    double dl=fmax(fmax(left->minX-p.x, p.x-left->maxX), fmax(left->minY-p.y, p.y-left->maxY));
+    double dr=fmax(fmax(right->minX-p.x, p.x-right->maxX), fmax(right->minY-p.y, p.y-right->maxY));
+
+    if(dl<=dr)
+    {
+        kdSearchK(t, node->left, p, k, except, nb, dists, cpt);
+        kdSearchK(t, node->right, p, k, except, nb, dists, cpt);
+    }
+    else
+    {
+        kdSearchK(t, node->right, p, k, except, nb, dists, cpt);
+        kdSearchK(t, node->left, p, k, except, nb, dists, cpt);
+    }
+}
+
+/**
+ * \fn int kdNearestK(KdTree t, Point p, int k, int except, int *nb)
+ * \brief Fonction qui cherche les k points restants les plus proches de p.
+ * \param KdTree t : Arbre.
+ * \param Point p : Point de la requête.
+ * \param int k : Nombre de points cherchés.
+ * \param int except : Point ignoré (par exemple celui de la requête), -1 pour aucun.
+ * \param int *nb : Tableau de k indices, rempli du plus proche au plus lointain (le plus petit indice en cas d'égalité).
+ * \return Le nombre de points trouvés (moins de k s'il reste moins de k points).
+ *
+ * L'arbre n'est pas modifié : plusieurs threads peuvent l'interroger en même temps.
+ */
+
+int kdNearestK(KdTree t, Point p, int k, int except, int *nb)
+{
+    int cpt=0;
+
+    if(k<=0 || t->nbNodes==0)
+        return 0;
+
+    double *dists=malloc(k*sizeof(double));
+
+    kdSearchK(t, 0, p, k, except, nb, dists, &cpt);
+
+    free(dists);
+
+    return cpt;
+}
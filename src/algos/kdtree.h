@@ -0,0 +1,81 @@
+/**
+ * \file kdtree.h
+ * \brief Fichier d'en-tête de l'arbre k-d (index spatial des villes en 2 dimensions).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <stdbool.h>
+
+#include "../point.h"
+
+typedef struct _KdTree * KdTree;
+
+/**
+ * \fn bool kdSupports(int lengthType)
+ * \brief Fonction qui indique si une distance peut être indexée par l'arbre (distance croissante avec une norme du plan).
+ * \param int lengthType : Type de distance (voir point.h).
+ * \return true pour les distances euclidiennes, de manhattan et du maximum (arrondies ou non), false pour GEO.
+ */
+
+bool kdSupports(int lengthType);
+
+/**
+ * \fn KdTree kdCreate(const double *xs, const double *ys, int n, int lengthType)
+ * \brief Fonction qui construit l'arbre k-d de n points.
+ * \param const double *xs : Abscisses des points.
+ * \param const double *ys : Ordonnées des points.
+ * \param int n : Nombre de points, indicés de 0 à n-1.
+ * \param int lengthType : Type de distance des requêtes (voir kdSupports).
+ * \return L'arbre, en O(n log n).
+ */
+
+KdTree kdCreate(const double *xs, const double *ys, int n, int lengthType);
+
+/**
+ * \fn void kdDelete(KdTree t)
+ * \brief Fonction qui libère un arbre k-d.
+ * \param KdTree t : Arbre à libérer.
+ * \return void
+ */
+
+void kdDelete(KdTree t);
+
+/**
+ * \fn void kdRemove(KdTree t, int i)
+ * \brief Fonction qui retire le point i de l'arbre (il ne sera plus renvoyé par kdNearest).
+ * \param KdTree t : Arbre.
+ * \param int i : Indice du point, encore présent.
+ * \return void
+ */
+
+void kdRemove(KdTree t, int i);
+
+/**
+ * \fn int kdNearest(KdTree t, Point p)
+ * \brief Fonction qui cherche le point restant le plus proche de p.
+ * \param KdTree t : Arbre.
+ * \param Point p : Point de la requête.
+ * \return L'indice du point le plus proche (le plus petit indice en cas d'égalité), -1 si l'arbre est vide.
+ */
+
+int kdNearest(KdTree t, Point p);
+
+/**
+ * \fn int kdNearestK(KdTree t, Point p, int k, int except, int *nb)
+ * \brief Fonction qui cherche les k points restants les plus proches de p.
+ * \param KdTree t : Arbre.
+ * \param Point p : Point de la requête.
+ * \param int k : Nombre de points cherchés.
+ * \param int except : Point ignoré (par exemple celui de la requête), -1 pour aucun.
+ * \param int *nb : Tableau de k indices, rempli du plus proche au plus lointain (le plus petit indice en cas d'égalité).
+ * \return Le nombre de points trouvés (moins de k s'il reste moins de k points).
+ */
+
+int kdNearestK(KdTree t, Point p, int k, int except, int *nb);
+
+#endif
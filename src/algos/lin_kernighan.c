@@ -0,0 +1,431 @@
+/**
+ * \file lin_kernighan.c
+ * \brief Fichier implémentant l'algorithme de Lin-Kernighan (recherche locale à profondeur variable, itérée).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Un mouvement part d'une arête (t1, t2) retirée, puis ajoute une arête (t2, t3) vers un plus proche voisin de t2 et
+ * retire une arête (t3, t4) de façon à pouvoir refermer le chemin par (t4, t1) : c'est un mouvement 2-opt, appliqué tout
+ * de suite sur le chemin. La recherche continue depuis t4 tant que le gain partiel reste positif, jusqu'à LK_MAX_DEPTH
+ * niveaux ; le chemin est ensuite ramené au meilleur niveau atteint, ou à son état de départ si aucun n'est gagnant.
+ * On obtient ainsi des mouvements k-opt séquentiels pour tout k. Le premier niveau essaie LK_BREADTH voisins, les
+ * suivants seulement le meilleur.
+ *
+ * Une fois le chemin localement optimal, il est perturbé (double pont entre trois trajets courts voisins) et de nouveau
+ * optimisé, tant que la durée donnée par setLkTimeLimit n'est pas écoulée. Une perturbation qui n'améliore pas le chemin
+ * est annulée en rejouant à l'envers les mouvements notés depuis. Le tirage des perturbations est déterministe.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "../city.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "tour.h"
+#include "nearest_neighbour.h"
+#include "lin_kernighan.h"
+
+/**
+ * \def LK_NEIGHBOURS
+ * \brief Nombre de plus proches voisins essayés par ville, si la Map n'a pas déjà des listes de voisins.
+ */
+
+#define LK_NEIGHBOURS 10
+
+/**
+ * \def LK_MAX_DEPTH
+ * \brief Nombre maximum de mouvements 2-opt enchaînés par un mouvement de Lin-Kernighan.
+ */
+
+#define LK_MAX_DEPTH 50
+
+/**
+ * \def LK_BREADTH
+ * \brief Nombre de voisins t3 essayés au premier niveau.
+ */
+
+#define LK_BREADTH 5
+
+/**
+ * \def LK_KICK_SEGMENT
+ * \brief Longueur maximum des trajets échangés par une perturbation.
+ */
+
+#define LK_KICK_SEGMENT 50
+
+/**
+ * \def LK_EPS
+ * \brief Gain minimum d'un mouvement (évite de boucler sur des égalités d'arrondi).
+ */
+
+#define LK_EPS 1e-9
+
+double lkTimeLimit=1;
+
+/**
+ * \struct LkSearch
+ * \brief État de la recherche : chemin, file des villes à essayer et journal des mouvements appliqués.
+ */
+
+typedef struct
+{
+    Map m; /*!< Map du chemin. */
+    Tour t; /*!< Chemin. */
+    int n; /*!< Nombre de villes. */
+    int *queue; /*!< File circulaire des villes à essayer (bits "don't look"). */
+    bool *inQueue; /*!< Villes présentes dans la file. */
+    int head; /*!< Tête de la file. */
+    int size; /*!< Nombre de villes dans la file. */
+    int *moves; /*!< Journal des mouvements 2-opt (a, b, c, d) appliqués. */
+    int nbMoves; /*!< Nombre de mouvements du journal. */
+    int maxMoves; /*!< Capacité du journal. */
+    unsigned int seed; /*!< État du générateur pseudo-aléatoire des perturbations. */
+} LkSearch;
+
+/**
+ * \fn void setLkTimeLimit(double seconds)
+ * \brief Fonction qui règle la durée des perturbations de linKernighan.
+ * \param double seconds : Durée en secondes (0 pour s'arrêter au premier optimum local).
+ * \return void
+ */
+
+void setLkTimeLimit(double seconds)
+{
+    lkTimeLimit=seconds;
+}
+
+/**
+ * \fn static unsigned int lkRandom(LkSearch *s)
+ * \brief Fonction qui retourne un entier pseudo-aléatoire (xorshift 32 bits).
+ */
+
+static unsigned int lkRandom(LkSearch *s)
+{
+    s->seed^=s->seed<<13;
+    s->seed^=s->seed>>17;
+    s->seed^=s->seed<<5;
+    return s->seed;
+}
+
+/**
+ * \fn static void lkPush(LkSearch *s, int a)
+ * \brief Fonction qui remet la ville a dans la file des villes à essayer.
+ */
+
+static void lkPush(LkSearch *s, int a)
+{
+    if(!s->inQueue[a])
+    {
+        s->inQueue[a]=true;
+        s->queue[(s->head+s->size++)%s->n]=a;
+    }
+}
+
+/**
+ * \fn static void lkMove(LkSearch *s, int a, int b, int c, int d)
+ * \brief Fonction qui applique un mouvement 2-opt (voir tourMove2) et le note dans le journal.
+ */
+
+static void lkMove(LkSearch *s, int a, int b, int c, int d)
+{
+    if(s->nbMoves==s->maxMoves)
+    {
+        s->maxMoves*=2;
+        s->moves=realloc(s->moves, 4*s->maxMoves*sizeof(int));
+    }
+
+    int *mv=s->moves+4*s->nbMoves++;
+
+    mv[0]=a;
+    mv[1]=b;
+    mv[2]=c;
+    mv[3]=d;
+
+    tourMove2(s->t, a, b, c, d);
+}
+
+/**
+ * \fn static void lkUndo(LkSearch *s, int nbMoves)
+ * \brief Fonction qui annule les mouvements du journal jusqu'à n'en garder que nbMoves.
+ */
+
+static void lkUndo(LkSearch *s, int nbMoves)
+{
+    while(s->nbMoves>nbMoves)
+    {
+        int *mv=s->moves+4*--s->nbMoves;
+
+        tourMove2(s->t, mv[0], mv[2], mv[1], mv[3]); // (a, c) et (b, d) redeviennent (a, b) et (c, d)
+    }
+}
+
+/**
+ * \fn static bool lkIsAdded(const int *added, int nbAdded, int a, int b)
+ * \brief Fonction qui indique si l'arête (a, b) a été ajoutée par le mouvement en cours (elle ne peut plus être retirée).
+ */
+
+static bool lkIsAdded(const int *added, int nbAdded, int a, int b)
+{
+    for(int i=0; i<nbAdded; i++)
+        if((added[2*i]==a && added[2*i+1]==b) || (added[2*i]==b && added[2*i+1]==a))
+            return true;
+
+    return false;
+}
+
+/**
+ * \fn static bool lkValid(LkSearch *s, int t1, int last, int c, int d, const int *added, int nbAdded)
+ * \brief Fonction qui indique si l'ajout de (last, c) et le retrait de (c, d) prolongent le mouvement en cours.
+ */
+
+static bool lkValid(LkSearch *s, int t1, int last, int c, int d, const int *added, int nbAdded)
+{
+    return c!=t1 && d!=t1 && c!=tourNext(s->t, last) && c!=tourPrev(s->t, last) && !lkIsAdded(added, nbAdded, c, d);
+}
+
+/**
+ * \fn static double lkStep(LkSearch *s, int t1, int t2)
+ * \brief Fonction qui cherche un mouvement de Lin-Kernighan gagnant commençant par le retrait de l'arête (t1, t2).
+ * \return Le gain du mouvement appliqué (les villes touchées sont remises dans la file), 0 si aucun n'est gagnant.
+ */
+
+static double lkStep(LkSearch *s, int t1, int t2)
+{
+    Map m=s->m;
+    int k=mapGetNbNeighbours(m);
+    const int *nb2=mapGetNeighbours(m, t2);
+    int start=s->nbMoves;
+    int added[2*LK_MAX_DEPTH];
+    int tried=0;
+
+    for(int l=0; l<k && tried<LK_BREADTH; l++)
+    {
+        int t3=nb2[l];
+        double g=mapDist(m, t1, t2)-mapDist(m, t2, t3); // gain partiel, sans l'arête de fermeture
+
+        if(g<=LK_EPS) // voisins triés : les suivants sont plus loin
+            break;
+
+        int t4=tourNext(s->t, t2)==t1 ? tourNext(s->t, t3) : tourPrev(s->t, t3);
+
+        if(!lkValid(s, t1, t2, t3, t4, added, 0))
+            continue;
+
+        tried++;
+
+        int last=t2;
+        int nbAdded=0;
+        double bestGain=LK_EPS;
+        int bestMoves=start;
+
+        for(int depth=0; depth<LK_MAX_DEPTH; depth++)
+        {
+            lkMove(s, last, t1, t3, t4); // (t1, last) et (t3, t4) deviennent (last, t3) et (t1, t4)
+
+            added[2*nbAdded]=last;
+            added[2*nbAdded+1]=t3;
+            nbAdded++;
+
+            g+=mapDist(m, t3, t4);
+            last=t4;
+
+            if(g-mapDist(m, last, t1)>bestGain)
+            {
+                bestGain=g-mapDist(m, last, t1);
+                bestMoves=s->nbMoves;
+            }
+
+            // niveau suivant : le voisin de last qui laisse le plus grand gain partiel après le retrait
+            const int *nb=mapGetNeighbours(m, last);
+            bool forward=tourNext(s->t, last)==t1;
+            double bestLook=LK_EPS;
+
+            t3=-1;
+
+            for(int q=0; q<k; q++)
+            {
+                int c=nb[q];
+                double g1=g-mapDist(m, last, c);
+
+                if(g1<=LK_EPS)
+                    break;
+
+                int d=forward ? tourNext(s->t, c) : tourPrev(s->t, c);
+
+                if(g1+mapDist(m, c, d)>bestLook && lkValid(s, t1, last, c, d, added, nbAdded))
+                {
+                    bestLook=g1+mapDist(m, c, d);
+                    t3=c;
+                    t4=d;
+                }
+            }
+
+            if(t3<0)
+                break;
+
+            g-=mapDist(m, last, t3);
+        }
+
+        if(bestMoves>start)
+        {
+            lkUndo(s, bestMoves);
+
+            for(int i=start; i<bestMoves; i++)
+                for(int j=0; j<4; j++)
+                    lkPush(s, s->moves[4*i+j]);
+
+            return bestGain;
+        }
+
+        lkUndo(s, start);
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static double lkOptimize(LkSearch *s)
+ * \brief Fonction qui applique des mouvements de Lin-Kernighan depuis les villes de la file jusqu'à ce qu'elle soit vide.
+ * \return Le gain total.
+ */
+
+static double lkOptimize(LkSearch *s)
+{
+    double gain=0;
+
+    while(s->size>0)
+    {
+        int t1=s->queue[s->head];
+        double g=lkStep(s, t1, tourNext(s->t, t1));
+
+        if(g==0)
+            g=lkStep(s, t1, tourPrev(s->t, t1));
+
+        if(g>0)
+        {
+            gain+=g;
+            continue; // t1 reste en tête
+        }
+
+        s->inQueue[t1]=false;
+        s->head=(s->head+1)%s->n;
+        s->size--;
+    }
+
+    return gain;
+}
+
+/**
+ * \fn static double lkKick(LkSearch *s)
+ * \brief Fonction qui perturbe le chemin par un double pont A B C D -> A C B D, avec B et C courts et consécutifs.
+ * \return La variation de longueur du chemin.
+ */
+
+static double lkKick(LkSearch *s)
+{
+    Map m=s->m;
+    int maxLen=(s->n-2)/3<LK_KICK_SEGMENT ? (s->n-2)/3 : LK_KICK_SEGMENT;
+    int a=lkRandom(s)%s->n;
+    int l1=1+lkRandom(s)%maxLen;
+    int l2=1+lkRandom(s)%maxLen;
+    int b1=tourNext(s->t, a), b2=b1;
+
+    for(int i=1; i<l1; i++)
+        b2=tourNext(s->t, b2);
+
+    int c1=tourNext(s->t, b2), c2=c1;
+
+    for(int i=1; i<l2; i++)
+        c2=tourNext(s->t, c2);
+
+    int d=tourNext(s->t, c2);
+    double delta=mapDist(m, a, c1)+mapDist(m, c2, b1)+mapDist(m, b2, d)
+                 -mapDist(m, a, b1)-mapDist(m, b2, c1)-mapDist(m, c2, d);
+
+    lkMove(s, a, b1, c2, d); // A B C D -> A C' B' D
+    lkMove(s, a, c2, c1, b2); // -> A C B' D
+    lkMove(s, c2, b2, b1, d); // -> A C B D
+
+    int touched[6]={a, b1, b2, c1, c2, d};
+
+    for(int i=0; i<6; i++)
+        lkPush(s, touched[i]);
+
+    return delta;
+}
+
+/**
+ * \fn City* linKernighan(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme de Lin-Kernighan itéré, depuis le chemin du plus proche voisin.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* linKernighan(Map m, City c)
+{
+    int n=mapGetSize(m);
+    City *path=nearestNeighbour(m, c);
+
+    if(n<5)
+        return path;
+
+    if(!mapIsSymmetric(m)) // les gains supposent d(i, j) == d(j, i), sinon lkOptimize peut boucler
+    {
+        throwWarn("LinKernighan", "Distances are not symmetric, returning the nearestNeighbour path (linKernighan)", NULL);
+        return path;
+    }
+
+    if(mapGetNbNeighbours(m)==0)
+        mapBuildNeighbours(m, LK_NEIGHBOURS);
+
+    LkSearch s;
+
+    s.m=m;
+    s.t=tourCreate(path, n);
+    s.n=n;
+    s.queue=malloc(n*sizeof(int));
+    s.inQueue=malloc(n*sizeof(bool));
+    s.head=0;
+    s.size=n;
+    s.maxMoves=1024;
+    s.moves=malloc(4*s.maxMoves*sizeof(int));
+    s.nbMoves=0;
+    s.seed=2463534242u;
+
+    for(int i=0; i<n; i++)
+    {
+        s.queue[i]=cityGetIndex(path[i]);
+        s.inQueue[i]=true;
+    }
+
+    clock_t begin=clock();
+
+    lkOptimize(&s);
+
+    if(n>=8)
+        while((double)(clock()-begin)/CLOCKS_PER_SEC<lkTimeLimit)
+        {
+            s.nbMoves=0; // le journal ne garde que les mouvements depuis la perturbation
+
+            double delta=lkKick(&s);
+
+            delta-=lkOptimize(&s);
+
+            if(delta>-LK_EPS) // pas d'amélioration : retour au meilleur chemin
+                lkUndo(&s, 0);
+        }
+
+    tourToPath(s.t, m, cityGetIndex(c), path);
+
+    free(s.moves);
+    free(s.inQueue);
+    free(s.queue);
+    tourDelete(s.t);
+
+    return path;
+}
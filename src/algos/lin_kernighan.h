@@ -0,0 +1,34 @@
+/**
+ * \file lin_kernighan.h
+ * \brief Fichier d'en-tête de l'algorithme de Lin-Kernighan (recherche locale à profondeur variable, itérée).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef LIN_KERNIGHAN_H_INCLUDED
+#define LIN_KERNIGHAN_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn void setLkTimeLimit(double seconds)
+ * \brief Fonction qui règle la durée des perturbations de linKernighan (1 seconde par défaut).
+ * \param double seconds : Durée en secondes (0 pour s'arrêter au premier optimum local).
+ * \return void
+ */
+
+void setLkTimeLimit(double seconds);
+
+/**
+ * \fn City* linKernighan(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme de Lin-Kernighan itéré, depuis le chemin du plus proche voisin.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
+ * \return Un chemin sous la forme d'un tableau de City.
+ */
+
+City* linKernighan(Map m, City c);
+
+#endif // LIN_KERNIGHAN_H_INCLUDED
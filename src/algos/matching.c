@@ -0,0 +1,696 @@
+/**
+ * \file matching.c
+ * \brief Fichier implémentant le couplage parfait de poids minimum (utilisé par Christofides).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Le couplage optimal est un couplage de poids maximum (algorithme des fleurs d'Edmonds avec variables duales, en O(n³))
+ * sur le graphe complet des villes, de poids W-d pour une distance d : W est assez grand pour que tout couplage de
+ * poids maximum soit parfait, qui est alors de distance totale minimum. Les distances sont ramenées à des entiers
+ * (1e6 pour la plus grande) pour que les variables duales restent exactes.
+ *
+ * Les sommets sont indicés de 1 à n (0 veut dire "aucun"), les fleurs (cycles impairs contractés) de n+1 à 2n.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#include "../map.h"
+#include "../fcts.h"
+#include "matching.h"
+#include "kdtree.h"
+
+/**
+ * \def MATCHING_SCALE
+ * \brief Valeur entière donnée à la plus grande distance à coupler.
+ */
+
+#define MATCHING_SCALE 1000000
+
+/**
+ * \struct BlEdge
+ * \brief Arête du graphe de l'algorithme des fleurs : entre deux fleurs, la meilleure arête entre deux de leurs sommets.
+ */
+
+typedef struct
+{
+    int u; /*!< Premier sommet (d'origine) de l'arête. */
+    int v; /*!< Second sommet (d'origine) de l'arête. */
+    long long w; /*!< Poids (0 pour aucune arête). */
+} BlEdge;
+
+/** \struct _Blossom
+ *  \brief État de l'algorithme des fleurs.
+ */
+
+typedef struct
+{
+    int n; /*!< Nombre de sommets. */
+    int nx; /*!< Plus grand indice de sommet ou de fleur utilisé. */
+    int stride; /*!< Largeur des tableaux à deux dimensions (2n+1). */
+    BlEdge *g; /*!< Arêtes entre sommets et fleurs, g[x*stride+y]. */
+    long long *lab; /*!< Variables duales des sommets et des fleurs. */
+    int *match; /*!< Sommet couplé à chaque sommet ou fleur (0 si aucun). */
+    int *slack; /*!< Sommet donnant l'arête la plus serrée vers chaque fleur extérieure. */
+    int *st; /*!< Fleur de plus haut niveau contenant chaque sommet ou fleur. */
+    int *pa; /*!< Sommet par lequel chaque sommet a été atteint dans l'arbre alterné. */
+    int *S; /*!< Étiquette dans l'arbre alterné : 0 pair, 1 impair, -1 non atteint. */
+    int *vis; /*!< Marques de la recherche d'ancêtre commun. */
+    int visT; /*!< Marque courante. */
+    int *flowerFrom; /*!< flowerFrom[b*(n+1)+x] : sous-fleur directe de b contenant le sommet x (0 si aucune). */
+    int *flower; /*!< Sous-fleurs de chaque fleur dans l'ordre du cycle, flower[b*(n+1)+i]. */
+    int *flowerSize; /*!< Nombre de sous-fleurs de chaque fleur. */
+    int *queue; /*!< File des sommets pairs à traiter. */
+    int qHead; /*!< Tête de la file. */
+    int qTail; /*!< Fin de la file. */
+    int qMax; /*!< Capacité de la file. */
+} Blossom;
+
+/**
+ * \def BL_G(b, x, y)
+ * \brief Arête (BlEdge) entre les sommets ou fleurs x et y.
+ */
+
+#define BL_G(b, x, y) ((b)->g[(size_t)(x)*(b)->stride+(y)])
+
+/**
+ * \def BL_DIST(b, e)
+ * \brief Écart de l'arête e à sa contrainte duale (lab[u]+lab[v]-2w) : l'arête est serrée quand il vaut 0.
+ */
+
+#define BL_DIST(b, e) ((b)->lab[(e).u]+(b)->lab[(e).v]-(e).w*2)
+
+/**
+ * \def BL_FLOWER(b, x)
+ * \brief Tableau des sous-fleurs de la fleur x, dans l'ordre du cycle.
+ */
+
+#define BL_FLOWER(b, x) ((b)->flower+(size_t)(x)*((b)->n+1))
+
+/**
+ * \def BL_FROM(b, x, y)
+ * \brief Sous-fleur directe de la fleur x contenant le sommet y (0 si aucune).
+ */
+
+#define BL_FROM(b, x, y) ((b)->flowerFrom[(size_t)(x)*((b)->n+1)+(y)])
+
+/**
+ * \fn static void blUpdateSlack(Blossom *b, int u, int x)
+ * \brief Fonction qui garde u comme sommet de slack[x] si son arête vers x est plus serrée que celle retenue.
+ */
+
+static void blUpdateSlack(Blossom *b, int u, int x)
+{
+    if(!b->slack[x] || BL_DIST(b, BL_G(b, u, x))<BL_DIST(b, BL_G(b, b->slack[x], x)))
+        b->slack[x]=u;
+}
+
+/**
+ * \fn static void blSetSlack(Blossom *b, int x)
+ * \brief Fonction qui recalcule slack[x] à partir de tous les sommets pairs extérieurs à x.
+ */
+
+static void blSetSlack(Blossom *b, int x)
+{
+    b->slack[x]=0;
+    for(int u=1; u<=b->n; u++)
+        if(BL_G(b, u, x).w>0 && b->st[u]!=x && b->S[b->st[u]]==0)
+            blUpdateSlack(b, u, x);
+}
+
+/**
+ * \fn static void blPush(Blossom *b, int x)
+ * \brief Fonction qui ajoute à la file le sommet x, ou tous les sommets de la fleur x.
+ */
+
+static void blPush(Blossom *b, int x)
+{
+    if(x<=b->n)
+    {
+        if(b->qTail==b->qMax)
+        {
+            b->qMax*=2;
+            b->queue=realloc(b->queue, b->qMax*sizeof(int));
+        }
+        b->queue[b->qTail++]=x;
+    }
+    else
+        for(int i=0; i<b->flowerSize[x]; i++)
+            blPush(b, BL_FLOWER(b, x)[i]);
+}
+
+/**
+ * \fn static void blSetSt(Blossom *b, int x, int top)
+ * \brief Fonction qui donne top comme fleur de plus haut niveau à x et à tout ce qu'il contient.
+ */
+
+static void blSetSt(Blossom *b, int x, int top)
+{
+    b->st[x]=top;
+    if(x>b->n)
+        for(int i=0; i<b->flowerSize[x]; i++)
+            blSetSt(b, BL_FLOWER(b, x)[i], top);
+}
+
+/**
+ * \fn static void blReverse(int *arr, int lo, int hi)
+ * \brief Fonction qui inverse l'ordre des éléments arr[lo] à arr[hi-1].
+ */
+
+static void blReverse(int *arr, int lo, int hi)
+{
+    for(hi--; lo<hi; lo++, hi--)
+    {
+        int tmp=arr[lo];
+        arr[lo]=arr[hi];
+        arr[hi]=tmp;
+    }
+}
+
+/**
+ * \fn static int blGetPr(Blossom *b, int top, int xr)
+ * \brief Fonction qui retourne la position de la sous-fleur xr dans le cycle de top, en orientant le cycle pour que cette position soit paire.
+ */
+
+static int blGetPr(Blossom *b, int top, int xr)
+{
+    int *fl=BL_FLOWER(b, top);
+    int size=b->flowerSize[top];
+    int pr=0;
+
+    while(fl[pr]!=xr)
+        pr++;
+
+    if(pr%2==1)
+    {
+        blReverse(fl, 1, size);
+        return size-pr;
+    }
+
+    return pr;
+}
+
+/**
+ * \fn static void blSetMatch(Blossom *b, int u, int v)
+ * \brief Fonction qui couple u par son arête vers v ; si u est une fleur, elle recouple son cycle et prend pour base la sous-fleur de cette arête.
+ */
+
+static void blSetMatch(Blossom *b, int u, int v)
+{
+    BlEdge e=BL_G(b, u, v);
+
+    b->match[u]=e.v;
+
+    if(u>b->n)
+    {
+        int xr=BL_FROM(b, u, e.u);
+        int pr=blGetPr(b, u, xr);
+        int *fl=BL_FLOWER(b, u);
+        int size=b->flowerSize[u];
+
+        for(int i=0; i<pr; i++)
+            blSetMatch(b, fl[i], fl[i^1]);
+
+        blSetMatch(b, xr, v);
+
+        // rotation du cycle pour que xr soit la base
+        blReverse(fl, 0, pr);
+        blReverse(fl, pr, size);
+        blReverse(fl, 0, size);
+    }
+}
+
+/**
+ * \fn static void blAugment(Blossom *b, int u, int v)
+ * \brief Fonction qui couple u à v puis inverse le chemin alterné de u jusqu'à la racine de son arbre.
+ */
+
+static void blAugment(Blossom *b, int u, int v)
+{
+    while(true)
+    {
+        int xnv=b->st[b->match[u]];
+
+        blSetMatch(b, u, v);
+
+        if(!xnv)
+            return;
+
+        blSetMatch(b, xnv, b->st[b->pa[xnv]]);
+        u=b->st[b->pa[xnv]];
+        v=xnv;
+    }
+}
+
+/**
+ * \fn static int blGetLca(Blossom *b, int u, int v)
+ * \brief Fonction qui remonte en alternance les arbres de u et de v à la recherche de leur premier ancêtre commun.
+ * \return L'ancêtre commun, 0 si u et v sont dans deux arbres différents.
+ */
+
+static int blGetLca(Blossom *b, int u, int v)
+{
+    b->visT++;
+
+    while(u || v)
+    {
+        if(u)
+        {
+            if(b->vis[u]==b->visT)
+                return u;
+
+            b->vis[u]=b->visT;
+            u=b->st[b->match[u]];
+            if(u)
+                u=b->st[b->pa[u]];
+        }
+
+        int tmp=u;
+        u=v;
+        v=tmp;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static void blAddBlossom(Blossom *b, int u, int lca, int v)
+ * \brief Fonction qui contracte en une nouvelle fleur le cycle impair formé par l'arête (u, v) et les chemins de u et de v jusqu'à lca.
+ */
+
+static void blAddBlossom(Blossom *b, int u, int lca, int v)
+{
+    int top=b->n+1;
+
+    while(top<=b->nx && b->st[top])
+        top++;
+
+    if(top>b->nx)
+        b->nx++;
+
+    b->lab[top]=0;
+    b->S[top]=0;
+    b->match[top]=b->match[lca];
+
+    int *fl=BL_FLOWER(b, top);
+    int size=0;
+
+    fl[size++]=lca;
+
+    for(int x=u, y; x!=lca; x=b->st[b->pa[y]])
+    {
+        fl[size++]=x;
+        fl[size++]=y=b->st[b->match[x]];
+        blPush(b, y);
+    }
+
+    blReverse(fl, 1, size);
+
+    for(int x=v, y; x!=lca; x=b->st[b->pa[y]])
+    {
+        fl[size++]=x;
+        fl[size++]=y=b->st[b->match[x]];
+        blPush(b, y);
+    }
+
+    b->flowerSize[top]=size;
+    blSetSt(b, top, top);
+
+    for(int x=1; x<=b->nx; x++)
+        BL_G(b, top, x).w=BL_G(b, x, top).w=0;
+    for(int x=1; x<=b->n; x++)
+        BL_FROM(b, top, x)=0;
+
+    for(int i=0; i<size; i++)
+    {
+        int xs=fl[i];
+
+        for(int x=1; x<=b->nx; x++)
+            if(BL_G(b, top, x).w==0 || BL_DIST(b, BL_G(b, xs, x))<BL_DIST(b, BL_G(b, top, x)))
+            {
+                BL_G(b, top, x)=BL_G(b, xs, x);
+                BL_G(b, x, top)=BL_G(b, x, xs);
+            }
+
+        for(int x=1; x<=b->n; x++)
+            if(BL_FROM(b, xs, x))
+                BL_FROM(b, top, x)=xs;
+    }
+
+    blSetSlack(b, top);
+}
+
+/**
+ * \fn static void blExpandBlossom(Blossom *b, int top)
+ * \brief Fonction qui défait la fleur impaire top (variable duale nulle) et étiquette ses sous-fleurs le long du chemin alterné qui la traverse.
+ */
+
+static void blExpandBlossom(Blossom *b, int top)
+{
+    int *fl=BL_FLOWER(b, top);
+    int size=b->flowerSize[top];
+
+    for(int i=0; i<size; i++)
+        blSetSt(b, fl[i], fl[i]);
+
+    int xr=BL_FROM(b, top, BL_G(b, top, b->pa[top]).u);
+    int pr=blGetPr(b, top, xr);
+
+    for(int i=0; i<pr; i+=2)
+    {
+        int xs=fl[i], xns=fl[i+1];
+
+        b->pa[xs]=BL_G(b, xns, xs).u;
+        b->S[xs]=1;
+        b->S[xns]=0;
+        b->slack[xs]=0;
+        blSetSlack(b, xns);
+        blPush(b, xns);
+    }
+
+    b->S[xr]=1;
+    b->pa[xr]=b->pa[top];
+
+    for(int i=pr+1; i<size; i++)
+    {
+        b->S[fl[i]]=-1;
+        blSetSlack(b, fl[i]);
+    }
+
+    b->st[top]=0;
+}
+
+/**
+ * \fn static bool blOnFoundEdge(Blossom *b, BlEdge e)
+ * \brief Fonction qui traite une arête serrée e partant d'un sommet pair : agrandit l'arbre, contracte une fleur ou augmente le couplage.
+ * \return true si le couplage a été augmenté.
+ */
+
+static bool blOnFoundEdge(Blossom *b, BlEdge e)
+{
+    int u=b->st[e.u], v=b->st[e.v];
+
+    if(b->S[v]==-1)
+    {
+        b->pa[v]=e.u;
+        b->S[v]=1;
+
+        int nu=b->st[b->match[v]];
+
+        b->slack[v]=b->slack[nu]=0;
+        b->S[nu]=0;
+        blPush(b, nu);
+    }
+    else if(b->S[v]==0)
+    {
+        int lca=blGetLca(b, u, v);
+
+        if(!lca)
+        {
+            blAugment(b, u, v);
+            blAugment(b, v, u);
+            return true;
+        }
+
+        blAddBlossom(b, u, lca, v);
+    }
+
+    return false;
+}
+
+/**
+ * \fn static bool blMatching(Blossom *b)
+ * \brief Fonction qui cherche un chemin augmentant, en ajustant les variables duales tant qu'aucune arête serrée ne permet d'avancer.
+ * \return true si le couplage a été augmenté, false s'il est de poids maximum.
+ */
+
+static bool blMatching(Blossom *b)
+{
+    for(int x=1; x<=b->nx; x++)
+    {
+        b->S[x]=-1;
+        b->slack[x]=0;
+    }
+
+    b->qHead=b->qTail=0;
+
+    for(int x=1; x<=b->nx; x++)
+        if(b->st[x]==x && !b->match[x])
+        {
+            b->pa[x]=0;
+            b->S[x]=0;
+            blPush(b, x);
+        }
+
+    if(b->qHead==b->qTail)
+        return false;
+
+    while(true)
+    {
+        while(b->qHead<b->qTail)
+        {
+            int u=b->queue[b->qHead++];
+
+            if(b->S[b->st[u]]==1)
+                continue;
+
+            for(int v=1; v<=b->n; v++)
+                if(BL_G(b, u, v).w>0 && b->st[u]!=b->st[v])
+                {
+                    if(BL_DIST(b, BL_G(b, u, v))==0)
+                    {
+                        if(blOnFoundEdge(b, BL_G(b, u, v)))
+                            return true;
+                    }
+                    else
+                        blUpdateSlack(b, u, b->st[v]);
+                }
+        }
+
+        long long d=LLONG_MAX;
+
+        for(int x=b->n+1; x<=b->nx; x++)
+            if(b->st[x]==x && b->S[x]==1 && b->lab[x]/2<d)
+                d=b->lab[x]/2;
+
+        for(int x=1; x<=b->nx; x++)
+            if(b->st[x]==x && b->slack[x])
+            {
+                long long dist=BL_DIST(b, BL_G(b, b->slack[x], x));
+
+                if(b->S[x]==-1 && dist<d)
+                    d=dist;
+                else if(b->S[x]==0 && dist/2<d)
+                    d=dist/2;
+            }
+
+        for(int u=1; u<=b->n; u++)
+        {
+            if(b->S[b->st[u]]==0)
+            {
+                if(b->lab[u]<=d)
+                    return false;
+                b->lab[u]-=d;
+            }
+            else if(b->S[b->st[u]]==1)
+                b->lab[u]+=d;
+        }
+
+        for(int x=b->n+1; x<=b->nx; x++)
+            if(b->st[x]==x)
+            {
+                if(b->S[x]==0)
+                    b->lab[x]+=d*2;
+                else if(b->S[x]==1)
+                    b->lab[x]-=d*2;
+            }
+
+        b->qHead=b->qTail=0;
+
+        for(int x=1; x<=b->nx; x++)
+            if(b->st[x]==x && b->slack[x] && b->st[b->slack[x]]!=x && BL_DIST(b, BL_G(b, b->slack[x], x))==0)
+                if(blOnFoundEdge(b, BL_G(b, b->slack[x], x)))
+                    return true;
+
+        for(int x=b->n+1; x<=b->nx; x++)
+            if(b->st[x]==x && b->S[x]==1 && b->lab[x]==0)
+                blExpandBlossom(b, x);
+    }
+}
+
+/**
+ * \fn static void blossomMatching(Map m, const int *vertices, int nb, int *mate)
+ * \brief Fonction qui calcule le couplage parfait de distance totale minimum par l'algorithme des fleurs.
+ */
+
+static void blossomMatching(Map m, const int *vertices, int nb, int *mate)
+{
+    Blossom b;
+    int n=nb;
+    int nn=2*n+1;
+    double maxDist=0;
+
+    b.n=n;
+    b.nx=n;
+    b.stride=nn;
+    b.g=malloc((size_t)nn*nn*sizeof(BlEdge));
+    b.lab=calloc(nn, sizeof(long long));
+    b.match=calloc(nn, sizeof(int));
+    b.slack=calloc(nn, sizeof(int));
+    b.st=calloc(nn, sizeof(int));
+    b.pa=calloc(nn, sizeof(int));
+    b.S=calloc(nn, sizeof(int));
+    b.vis=calloc(nn, sizeof(int));
+    b.visT=0;
+    b.flowerFrom=calloc((size_t)nn*(n+1), sizeof(int));
+    b.flower=malloc((size_t)nn*(n+1)*sizeof(int));
+    b.flowerSize=calloc(nn, sizeof(int));
+    b.qMax=nn;
+    b.queue=malloc(b.qMax*sizeof(int));
+
+    for(int i=0; i<n; i++)
+        for(int j=i+1; j<n; j++)
+            maxDist=fmax(maxDist, mapDist(m, vertices[i], vertices[j]));
+
+    double scale=maxDist>0 ? MATCHING_SCALE/maxDist : 0;
+    long long big=(long long)MATCHING_SCALE*(n+1)+1; // plus qu'une distance par arête d'un chemin augmentant : le couplage de poids maximum est parfait
+    long long wMax=0;
+
+    for(int x=0; x<nn; x++)
+        for(int y=0; y<nn; y++)
+        {
+            BL_G(&b, x, y).u=x;
+            BL_G(&b, x, y).v=y;
+            BL_G(&b, x, y).w=0;
+        }
+
+    for(int u=1; u<=n; u++)
+        for(int v=u+1; v<=n; v++)
+        {
+            long long w=big-llround(mapDist(m, vertices[u-1], vertices[v-1])*scale);
+
+            BL_G(&b, u, v).w=BL_G(&b, v, u).w=w;
+            if(w>wMax)
+                wMax=w;
+        }
+
+    for(int u=0; u<=n; u++)
+        b.st[u]=u;
+
+    for(int u=1; u<=n; u++)
+    {
+        BL_FROM(&b, u, u)=u;
+        b.lab[u]=wMax;
+    }
+
+    while(blMatching(&b));
+
+    for(int u=1; u<=n; u++)
+        mate[u-1]=b.match[u]-1;
+
+    free(b.queue);
+    free(b.flowerSize);
+    free(b.flower);
+    free(b.flowerFrom);
+    free(b.vis);
+    free(b.S);
+    free(b.pa);
+    free(b.st);
+    free(b.slack);
+    free(b.match);
+    free(b.lab);
+    free(b.g);
+}
+
+/**
+ * \fn static void greedyMatching(Map m, const int *vertices, int nb, int *mate)
+ * \brief Fonction qui couple chaque ville (dans l'ordre de vertices) à la plus proche restante.
+ *
+ * Les villes d'une Map de points sans matrice sont cherchées dans un arbre k-d, sinon les distances sont parcourues (O(nb²)).
+ */
+
+static void greedyMatching(Map m, const int *vertices, int nb, int *mate)
+{
+    const double *xs=mapGetXs(m);
+    const double *ys=mapGetYs(m);
+
+    for(int i=0; i<nb; i++)
+        mate[i]=-1;
+
+    if(xs && kdSupports(mapGetLengthType(m)))
+    {
+        double *px=malloc(nb*sizeof(double));
+        double *py=malloc(nb*sizeof(double));
+
+        for(int i=0; i<nb; i++)
+        {
+            px[i]=xs[vertices[i]];
+            py[i]=ys[vertices[i]];
+        }
+
+        KdTree t=kdCreate(px, py, nb, mapGetLengthType(m));
+
+        for(int i=0; i<nb; i++)
+            if(mate[i]<0)
+            {
+                kdRemove(t, i);
+
+                Point p={px[i], py[i]};
+                int j=kdNearest(t, p);
+
+                kdRemove(t, j);
+                mate[i]=j;
+                mate[j]=i;
+            }
+
+        kdDelete(t);
+        free(py);
+        free(px);
+        return;
+    }
+
+    for(int i=0; i<nb; i++)
+        if(mate[i]<0)
+        {
+            int best=-1;
+            double minDist=0;
+
+            for(int j=i+1; j<nb; j++)
+                if(mate[j]<0 && (best<0 || mapDist(m, vertices[i], vertices[j])<minDist))
+                {
+                    minDist=mapDist(m, vertices[i], vertices[j]);
+                    best=j;
+                }
+
+            mate[i]=best;
+            mate[best]=i;
+        }
+}
+
+/**
+ * \fn void perfectMatching(Map m, const int *vertices, int nb, int *mate)
+ * \brief Fonction qui couple deux à deux des villes de la Map en minimisant la somme des distances des couples.
+ * \param Map m : Map dont les distances sont utilisées.
+ * \param const int *vertices : Indices des villes à coupler.
+ * \param int nb : Nombre de villes à coupler (pair).
+ * \param int *mate : Rempli avec la position dans vertices de la ville couplée à chaque ville de vertices.
+ * \return void
+ */
+
+void perfectMatching(Map m, const int *vertices, int nb, int *mate)
+{
+    if(nb%2!=0)
+        throwErr("Matching", "Odd number of vertices to match (perfectMatching)", NULL);
+
+    if(nb==0)
+        return;
+
+    if(nb<=MATCHING_BLOSSOM_MAX)
+        blossomMatching(m, vertices, nb, mate);
+    else
+        greedyMatching(m, vertices, nb, mate);
+}
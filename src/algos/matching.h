@@ -0,0 +1,36 @@
+/**
+ * \file matching.h
+ * \brief Fichier d'en-tête du couplage parfait de poids minimum (utilisé par Christofides).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef MATCHING_H
+#define MATCHING_H
+
+#include "../map.h"
+
+/**
+ * \def MATCHING_BLOSSOM_MAX
+ * \brief Nombre maximum de villes couplées par l'algorithme d'Edmonds (O(n³) en temps, O(n²) en mémoire) ; au-delà, le couplage est glouton.
+ */
+
+#define MATCHING_BLOSSOM_MAX 1000
+
+/**
+ * \fn void perfectMatching(Map m, const int *vertices, int nb, int *mate)
+ * \brief Fonction qui couple deux à deux des villes de la Map en minimisant la somme des distances des couples.
+ * \param Map m : Map dont les distances sont utilisées.
+ * \param const int *vertices : Indices des villes à coupler.
+ * \param int nb : Nombre de villes à coupler (pair).
+ * \param int *mate : Rempli avec la position dans vertices de la ville couplée à chaque ville de vertices.
+ * \return void
+ *
+ * Jusqu'à MATCHING_BLOSSOM_MAX villes, le couplage est optimal (algorithme des fleurs d'Edmonds pondéré, à une
+ * précision de 1e-6 fois la plus grande distance près). Au-delà, chaque ville est couplée à la plus proche restante.
+ */
+
+void perfectMatching(Map m, const int *vertices, int nb, int *mate);
+
+#endif
@@ -4,8 +4,14 @@
  * \author Nicolas Marcy
  * \version
  * \date
+ *
+ * Sur une matrice, l'arbre est construit par Prim avec un tableau de clés (O(n²)). Sur une Map de points sans matrice,
+ * il est construit par Kruskal sur les arêtes vers les plus proches voisins (union-find), ce qui passe à 100k villes et plus.
  */
 
+#include <stdlib.h>
+#include <stdbool.h>
+
 #include "../city.h"
 #include "../point.h"
 #include "../map.h"
@@ -13,6 +19,249 @@
 #include "tree.h"
 #include "algos.h"
 #include "minimum_spanning_tree.h"
+#include "kdtree.h"
+#include "edges.h"
+
+/**
+ * \def MST_NEIGHBOURS
+ * \brief Nombre de plus proches voisins par ville dont les arêtes sont données à Kruskal (doublé tant que le graphe n'est pas connexe).
+ */
+
+#define MST_NEIGHBOURS 10
+
+/**
+ * \fn static void mstPrim(Map m, int root, int *fathers, int *sons)
+ * \brief Fonction qui construit l'arbre couvrant minimum par Prim avec un tableau de clés.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param int root : Ville de départ, racine de l'arbre.
+ * \param int *fathers : Rempli avec le père de chaque ville ajoutée (nbCities-1 cases).
+ * \param int *sons : Rempli avec les villes dans l'ordre où elles sont ajoutées à l'arbre.
+ * \return void
+ *
+ * key[j] est la distance de j à l'arbre et parent[j] le premier sommet de l'arbre à cette distance : chaque étape
+ * parcourt une fois les villes restantes, l'arbre est obtenu en O(n²). Les égalités sont départagées comme le parcours
+ * complet d'origine (sommet de l'arbre ajouté le plus tôt, puis plus petit indice, l'arête entre le plus petit indice
+ * de l'arbre et le plus petit indice hors de l'arbre gardant la priorité), le chemin obtenu est donc le même.
+ */
+
+static void mstPrim(Map m, int root, int *fathers, int *sons)
+{
+    int nbCities=mapGetSize(m);
+    double *key=malloc(nbCities*sizeof(double));
+    int *parent=malloc(nbCities*sizeof(int));
+    int *rank=malloc(nbCities*sizeof(int)); // ordre d'ajout à l'arbre
+    int *rest=malloc(nbCities*sizeof(int)); // villes hors de l'arbre
+    int *restPos=malloc(nbCities*sizeof(int)); // position de chaque ville dans rest
+    bool *inTree=calloc(nbCities, sizeof(bool));
+    int nbRest=0;
+
+    for(int j=0; j<nbCities; j++)
+        if(j!=root)
+        {
+            restPos[j]=nbRest;
+            rest[nbRest++]=j;
+            key[j]=mapDist(m, root, j);
+            parent[j]=root;
+        }
+
+    inTree[root]=true;
+    rank[root]=0;
+
+    int minIn=root; // plus petit indice de l'arbre
+    int minOut=root==0 ? 1 : 0; // plus petit indice hors de l'arbre
+
+    for(int k=1; k<nbCities; k++)
+    {
+        int best=0; // position dans rest de la ville ajoutée
+
+        for(int r=1; r<nbRest; r++)
+        {
+            int j=rest[r], b=rest[best];
+
+            if(key[j]<key[b] || (key[j]==key[b] && (rank[parent[j]]<rank[parent[b]] || (rank[parent[j]]==rank[parent[b]] && j<b))))
+                best=r;
+        }
+
+        int iEnd=rest[best];
+        int iBegin=parent[iEnd];
+
+        if(mapDist(m, minIn, minOut)==key[iEnd])
+        {
+            iBegin=minIn;
+            iEnd=minOut;
+            best=restPos[iEnd];
+        }
+
+        fathers[k-1]=iBegin;
+        sons[k-1]=iEnd;
+        inTree[iEnd]=true;
+        rank[iEnd]=k;
+        rest[best]=rest[--nbRest];
+        restPos[rest[best]]=best;
+
+        if(iEnd<minIn)
+            minIn=iEnd;
+        while(minOut<nbCities && inTree[minOut])
+            minOut++;
+
+        for(int r=0; r<nbRest; r++)
+        {
+            int j=rest[r];
+            double dist=mapDist(m, iEnd, j);
+
+            if(dist<key[j])
+            {
+                key[j]=dist;
+                parent[j]=iEnd;
+            }
+        }
+    }
+
+    free(inTree);
+    free(restPos);
+    free(rest);
+    free(rank);
+    free(parent);
+    free(key);
+}
+
+/**
+ * \fn static void mstKruskal(Map m, int root, int *fathers, int *sons)
+ * \brief Fonction qui construit un arbre couvrant par Kruskal sur les arêtes vers les plus proches voisins.
+ * \param Map m : Map de points sans matrice à laquelle est appliqué l'algorithme.
+ * \param int root : Ville de départ, racine de l'arbre.
+ * \param int *fathers : Rempli avec le père de chaque ville (nbCities-1 cases, dans l'ordre de sons).
+ * \param int *sons : Rempli avec les villes de l'arbre dans un ordre où chaque père précède ses fils (parcours en largeur depuis root).
+ * \return void
+ *
+ * Les arêtes candidates sont triées puis ajoutées si elles relient deux composantes (union-find avec compression de
+ * chemin et union par rang) : O(nk log n). C'est l'arbre couvrant minimum du graphe des k plus proches voisins, égal à
+ * l'arbre couvrant minimum tant que ses arêtes sont parmi les candidates ; si ce graphe n'est pas connexe, k est doublé.
+ */
+
+static void mstKruskal(Map m, int root, int *fathers, int *sons)
+{
+    int nbCities=mapGetSize(m);
+    int k=mapGetNbNeighbours(m)>0 ? mapGetNbNeighbours(m) : MST_NEIGHBOURS;
+    int *set=malloc(nbCities*sizeof(int));
+    int *rank=malloc(nbCities*sizeof(int));
+    int *tree=malloc(2*(nbCities-1)*sizeof(int)); // arêtes gardées
+    int nbTree;
+
+    while(true)
+    {
+        mapBuildNeighbours(m, k);
+        k=mapGetNbNeighbours(m);
+
+        size_t nbEdges;
+        Edge *edges=edgesFromNeighbours(m, -1, &nbEdges);
+
+        qsort(edges, nbEdges, sizeof(Edge), edgesCompare);
+
+        for(int i=0; i<nbCities; i++)
+        {
+            set[i]=i;
+            rank[i]=0;
+        }
+
+        nbTree=0;
+
+        for(size_t e=0; e<nbEdges && nbTree<nbCities-1; e++)
+        {
+            int ru=edgesFind(set, edges[e].u);
+            int rv=edgesFind(set, edges[e].v);
+
+            if(ru==rv)
+                continue;
+
+            if(rank[ru]<rank[rv])
+                set[ru]=rv;
+            else
+            {
+                set[rv]=ru;
+                if(rank[ru]==rank[rv])
+                    rank[ru]++;
+            }
+
+            tree[2*nbTree]=edges[e].u;
+            tree[2*nbTree+1]=edges[e].v;
+            nbTree++;
+        }
+
+        free(edges);
+
+        if(nbTree==nbCities-1 || k>=nbCities-1)
+            break;
+
+        throwWarn("Map", "Neighbour graph is not connected, doubling the number of neighbours (minimumSpanningTree)", NULL);
+        k*=2;
+    }
+
+    // listes d'adjacence (CSR) des arêtes gardées, dans l'ordre où Kruskal les a prises
+    int *first=calloc(nbCities+1, sizeof(int));
+    int *adj=malloc(2*(nbCities-1)*sizeof(int));
+    bool *seen=calloc(nbCities, sizeof(bool));
+
+    for(int e=0; e<2*nbTree; e++)
+        first[tree[e]+1]++;
+    for(int i=0; i<nbCities; i++)
+        first[i+1]+=first[i];
+    for(int e=0; e<nbTree; e++)
+    {
+        adj[first[tree[2*e]]++]=tree[2*e+1];
+        adj[first[tree[2*e+1]]++]=tree[2*e];
+    }
+    for(int i=nbCities; i>0; i--)
+        first[i]=first[i-1];
+    first[0]=0;
+
+    // parcours en largeur depuis root : chaque ville est ajoutée après son père
+    int head=0, nbSons=0;
+    int current=root;
+
+    seen[root]=true;
+
+    while(true)
+    {
+        for(int a=first[current]; a<first[current+1]; a++)
+            if(!seen[adj[a]])
+            {
+                seen[adj[a]]=true;
+                fathers[nbSons]=current;
+                sons[nbSons++]=adj[a];
+            }
+
+        if(head==nbSons)
+            break;
+
+        current=sons[head++];
+    }
+
+    free(seen);
+    free(adj);
+    free(first);
+    free(tree);
+    free(rank);
+    free(set);
+}
+
+/**
+ * \fn void minimumSpanningTreeEdges(Map m, int root, int *fathers, int *sons)
+ * \brief Fonction qui construit l'arbre couvrant minimum de la Map, enraciné en root.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param int root : Indice de la racine.
+ * \param int *fathers : Rempli avec le père de chaque arête (mapGetSize(m)-1 cases).
+ * \param int *sons : Rempli avec le fils de chaque arête, chaque père apparaissant avant ses fils.
+ * \return void
+ */
+
+void minimumSpanningTreeEdges(Map m, int root, int *fathers, int *sons)
+{
+    if(mapGetXs(m) && kdSupports(mapGetLengthType(m)) && mapGetSize(m)>1)
+        mstKruskal(m, root, fathers, sons);
+    else
+        mstPrim(m, root, fathers, sons);
+}
 
 /**
  * \fn City* minimumSpanningTree(Map m, City cityBegin)
@@ -26,50 +275,22 @@ City* minimumSpanningTree(Map m, City cityBegin)
 {
     int nbCities=mapGetSize(m);
     City* path=arrCitiesCreate(nbCities+1);
-    City current;
-    double minDist;
-    int iBegin; // premier sommet de l'arête
-    int iEnd; // second sommet de l'arête
-    int iArray[nbCities]; // tableau des villes placées dans l'arbre
-    iArray[0]=cityGetIndex(cityBegin);
-    int iCount=1; // nombre de villes placées dans l'arbre
-
-    Tree T=createTree(nbCities);
-    addTopToTree(T,-1,cityGetIndex(cityBegin)); // ajout de l'indice de la ville de départ dans le tableau
-
-    while(iCount!=nbCities) // tant que tous les indices n'ont pas été inclus
-    {
-        iBegin=0;
-        iEnd=0;
-        while(!isInside(iArray,iCount,iBegin)) // on cherche un début d'arête qui est dans l'arbre
-            iBegin++;
-        while(isInside(iArray,iCount,iEnd)) // puis on cherche une fin d'arête qui n'est pas dans l'arbre
-            iEnd++;
-        minDist=cityGetDist(mapGetCity(m,iBegin),iEnd); // et on prend la distance entre ces 2 sommets, ce sera notre base de calcul de distance minimum
-        for(int i=0; i<iCount; i++) // on parcourt les sommets inclus
-        {
-            current=mapGetCity(m,iArray[i]); // on cherche la plus petite distance dans la liste des distances du sommet courant
-            for(int j=0; j<nbCities; j++)
-                if(iArray[i]!=j && !isInside(iArray,iCount,j) && cityGetDist(current,j)<minDist) // si ce second indice n'est pas déjà inclus et que la distance entre l'indice courant et celui-ci est plus petite que la distance courante
-                {
-                    minDist=cityGetDist(current,j); // on met à jour la distance minimum et les deux sommets d'arête
-                    iBegin=iArray[i];
-                    iEnd=j;
-                }
-        }
-        addTopToTree(T,iBegin,iEnd);
-        iArray[iCount++]=iEnd;
-    }
+    int root=cityGetIndex(cityBegin);
+    int *fathers=malloc(nbCities*sizeof(int)); // arêtes de l'arbre, dans l'ordre d'ajout
+    int *sons=malloc(nbCities*sizeof(int));
+
+    minimumSpanningTreeEdges(m, root, fathers, sons);
 
-    upToRoot(T); // on remonte en haut de l'arbre pour traiter tous les sommets
-    int treePath[nbCities];
-    int* tmpPath=treePath; // utilisation d'un pointeur car treePath est un tableau statique
-    fillIndexesArrayFromTree(T,&tmpPath); // on parcourt l'arbre en remplissant le tableau du path
-    upToRoot(T); // on remonte encore pour tout libérer
+    Tree T=createTree(nbCities, root, fathers, sons);
+    free(sons);
+    free(fathers);
+
+    int *treePath=malloc(nbCities*sizeof(int)); // pas sur la pile : peut contenir des millions de villes
+    fillIndexesArrayFromTree(T,treePath); // on parcourt l'arbre en remplissant le tableau du path
     destroyTree(T);
     for(int i=0; i<nbCities; ++i)
         path[i]=mapGetCity(m,treePath[i]);
     path[nbCities]=cityBegin;
+    free(treePath);
     return path;
 }
-
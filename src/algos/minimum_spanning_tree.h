@@ -19,5 +19,17 @@
  */
 City* minimumSpanningTree(Map m, City cityBegin);
 
+/**
+ * \fn void minimumSpanningTreeEdges(Map m, int root, int *fathers, int *sons)
+ * \brief Fonction qui construit l'arbre couvrant minimum de la Map, enraciné en root.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param int root : Indice de la racine.
+ * \param int *fathers : Rempli avec le père de chaque arête (mapGetSize(m)-1 cases).
+ * \param int *sons : Rempli avec le fils de chaque arête, chaque père apparaissant avant ses fils.
+ * \return void
+ */
+
+void minimumSpanningTreeEdges(Map m, int root, int *fathers, int *sons);
+
 
 #endif // MINIMUM_SPANNING_TREE_H_INCLUDED
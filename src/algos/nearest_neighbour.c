@@ -8,6 +8,9 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
 
 #include "../city.h"
 #include "../point.h"
@@ -15,6 +18,200 @@
 #include "../fcts.h"
 #include "algos.h"
 #include "nearest_neighbour.h"
+#include "kdtree.h"
+
+/**
+ * \def NN_MULTI_MAX_STARTS
+ * \brief Nombre maximum de villes de départ essayées par nearestNeighbourMulti (au-delà, elles sont réparties régulièrement).
+ */
+
+#define NN_MULTI_MAX_STARTS 1000
+
+/** \struct nn_params
+ *  \brief Paramètres d'un thread de nearestNeighbourMulti : il essaie les départs first, first+step, first+2*step...
+ */
+
+struct nn_params
+{
+    Map m; /*!< Map à laquelle est appliqué l'algorithme. */
+    int first; /*!< Premier départ essayé par le thread. */
+    int step; /*!< Écart entre deux départs essayés (nombre de threads). */
+    int nbStarts; /*!< Nombre total de départs. */
+    int sCity; /*!< Ville de départ demandée, premier des départs. */
+    int *minArr; /*!< Meilleur chemin trouvé par le thread (indices, nbCities+1). */
+    double minLength; /*!< Longueur de minArr. */
+    int minStart; /*!< Départ de minArr (pour départager les égalités). */
+};
+
+/**
+ * \fn static int nearestUnvisited(Map m, int curr, const int *rest, int nbRest, const double *rx, const double *ry, double *row)
+ * \brief Fonction qui cherche, parmi les villes pas encore visitées, la plus proche de la ville curr.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param int curr : Indice de la ville actuelle.
+ * \param const int *rest : Indices des villes pas encore visitées.
+ * \param int nbRest : Nombre de villes pas encore visitées.
+ * \param const double *rx : Abscisses des villes de rest (Map sans matrice), NULL sinon.
+ * \param const double *ry : Ordonnées des villes de rest.
+ * \param double *row : Tableau de nbRest distances pour les Map sans matrice non euclidiennes, NULL sinon.
+ * \return La position dans rest de la ville la plus proche (celle de plus petit indice en cas d'égalité).
+ *
+ * Sans matrice, les coordonnées des villes restantes sont parcourues dans des tableaux contigus : les distances
+ * euclidiennes sont comparées au carré (pas de racine), les autres sont calculées d'un coup par le noyau ligne de la
+ * distance de la Map. Sinon elles sont lues dans la matrice.
+ */
+
+static int nearestUnvisited(Map m, int curr, const int *rest, int nbRest, const double *rx, const double *ry, double *row)
+{
+    int next=0;
+    double minDist=INFINITY;
+
+    if(rx && !row)
+    {
+        double x=mapGetXs(m)[curr], y=mapGetYs(m)[curr];
+
+        for(int j=0; j<nbRest; j++)
+        {
+            double dx=rx[j]-x, dy=ry[j]-y;
+            double dist=dx*dx+dy*dy;
+
+            if(dist<minDist || (dist==minDist && rest[j]<rest[next]))
+            {
+                minDist=dist;
+                next=j;
+            }
+        }
+    }
+    else
+    {
+        if(row)
+        {
+            Point p={mapGetXs(m)[curr], mapGetYs(m)[curr]};
+            lengthGetRowFct(mapGetLengthType(m))(p, rx, ry, row, nbRest);
+        }
+
+        for(int j=0; j<nbRest; j++)
+        {
+            double dist=row ? row[j] : mapDist(m, curr, rest[j]);
+
+            if(dist<minDist || (dist==minDist && rest[j]<rest[next]))
+            {
+                minDist=dist;
+                next=j;
+            }
+        }
+    }
+
+    return next;
+}
+
+/**
+ * \fn static void nearestNeighbourKd(Map m, int sCity, int *tour)
+ * \brief Fonction qui construit le chemin Nearest Neighbour d'une Map sans matrice à l'aide d'un arbre k-d.
+ * \param Map m : Map à laquelle est appliqué l'algorithme (distance acceptée par kdSupports).
+ * \param int sCity : Ville de départ.
+ * \param int *tour : Chemin construit (nbCities indices, sans le retour).
+ * \return void
+ *
+ * Chaque ville visitée est retirée de l'arbre, la suivante est la plus proche des villes restantes : O(n log n) en pratique.
+ */
+
+static void nearestNeighbourKd(Map m, int sCity, int *tour)
+{
+    int nbCities=mapGetSize(m);
+    const double *xs=mapGetXs(m);
+    const double *ys=mapGetYs(m);
+    KdTree tree=kdCreate(xs, ys, nbCities, mapGetLengthType(m));
+
+    int curr=sCity; // ville actuelle
+
+    tour[0]=curr;
+    kdRemove(tree, curr);
+
+    for(int i=1; i<nbCities; i++)
+    {
+        Point p={xs[curr], ys[curr]};
+
+        curr=kdNearest(tree, p);
+        kdRemove(tree, curr);
+        tour[i]=curr;
+    }
+
+    kdDelete(tree);
+}
+
+/**
+ * \fn static void nearestNeighbourTour(Map m, int sCity, int *tour)
+ * \brief Fonction qui construit le chemin Nearest Neighbour partant de la ville sCity.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param int sCity : Ville de départ.
+ * \param int *tour : Chemin construit (nbCities indices, sans le retour).
+ * \return void
+ *
+ * Les villes pas encore visitées sont gardées dans un tableau dont on retire la ville choisie en la remplaçant par la
+ * dernière : chaque étape ne parcourt que les villes restantes. Les Map sans matrice passent par un arbre k-d
+ * (nearestNeighbourKd) quand leur distance le permet.
+ */
+
+static void nearestNeighbourTour(Map m, int sCity, int *tour) // complexité en temps : n²/2
+{
+    if(mapGetXs(m) && kdSupports(mapGetLengthType(m)))
+    {
+        nearestNeighbourKd(m, sCity, tour);
+        return;
+    }
+
+    int nbCities=mapGetSize(m);
+    int *rest=malloc(nbCities*sizeof(int)); // villes pas encore visitées
+    int nbRest=0;
+    double *rx=NULL, *ry=NULL, *row=NULL;
+
+    int curr=sCity; // ville actuelle
+
+    if(mapGetXs(m)) // pas de matrice : coordonnées des villes restantes
+    {
+        rx=malloc(nbCities*sizeof(double));
+        ry=malloc(nbCities*sizeof(double));
+
+        if(mapGetLengthType(m)!=EUCLIDIAN)
+            row=malloc(nbCities*sizeof(double));
+    }
+
+    for(int j=0; j<nbCities; j++)
+    {
+        if(j==curr)
+            continue;
+
+        if(rx)
+        {
+            rx[nbRest]=mapGetXs(m)[j];
+            ry[nbRest]=mapGetYs(m)[j];
+        }
+        rest[nbRest++]=j;
+    }
+
+    tour[0]=curr;
+
+    for(int i=1; i<nbCities; i++)
+    {
+        int next=nearestUnvisited(m, curr, rest, nbRest, rx, ry, row);
+
+        curr=rest[next];
+        tour[i]=curr;
+
+        nbRest--; // la dernière ville restante prend la place de la ville choisie
+        rest[next]=rest[nbRest];
+        if(rx)
+        {
+            rx[next]=rx[nbRest];
+            ry[next]=ry[nbRest];
+        }
+    }
+
+    free(rest);
+    free(rx);
+    free(ry);
+    free(row);
+}
 
 /**
  * \fn City* nearestNeighbour(Map m, City c)
@@ -24,82 +221,124 @@
  * \return Un chemin sous la forme d'un tableau de City.
  */
 
-City* nearestNeighbour(Map m, City c) // complexité en temps : n² - n
+City* nearestNeighbour(Map m, City c)
 {
     int nbCities=mapGetSize(m);
     City *path=arrCitiesCreate(nbCities+1);
-    int visited[nbCities]; // tableau des villes exclues
+    int *tour=arrIndexesCreate(nbCities);
 
-    int tmpIndex;
-    City currCity; // ville actuelle
-    double edge;
+    nearestNeighbourTour(m, cityGetIndex(c), tour);
 
-    path[0]=c;
-    visited[0]=cityGetIndex(c); // indice de la ville de départ
-    currCity=c;
+    for(int i=0; i<nbCities; i++)
+        path[i]=mapGetCity(m, tour[i]);
+    path[nbCities]=c;
 
-    for(int i=1; i<nbCities; i++)
+    freeArrIndexes(tour);
+
+    return path;
+}
+
+/**
+ * \fn static void *nearestNeighbour_thread(void *params)
+ * \brief Fonction d'un thread de nearestNeighbourMulti : construit le chemin de chacun de ses départs et garde le plus court.
+ * \param params pointeur vers la structure nn_params
+ */
+
+static void *nearestNeighbour_thread(void *params)
+{
+    struct nn_params *param=(struct nn_params *)params;
+    Map m=param->m;
+    int nbCities=mapGetSize(m);
+    int *tour=arrIndexesCreate(nbCities+1);
+
+    param->minLength=INFINITY;
+    param->minStart=-1;
+
+    for(int k=param->first; k<param->nbStarts; k+=param->step)
     {
-        int indexTest=0;
-        while(cityEquals(currCity, mapGetCity(m, indexTest)) || isInside(visited, i, indexTest)) // choix d'une ville qui servira pour le calcul des distances
-            indexTest++;
+        int start=(param->sCity+(int)((long long)k*nbCities/param->nbStarts))%nbCities; // départs répartis régulièrement à partir de sCity
 
-        if(indexTest>=nbCities)
-            return path;
+        nearestNeighbourTour(m, start, tour);
+        tour[nbCities]=tour[0];
 
-        edge=cityGetDist(currCity, indexTest);
-        tmpIndex=indexTest;
+        double length=calcPathLengthFromIndexesArr(m, tour);
 
-        for(int j=0; j<nbCities; j++)
+        if(length<param->minLength)
         {
-            if(!cityEquals(currCity, mapGetCity(m, j)) && !isInside(visited, i, j))
-                if(cityGetDist(currCity, j)<edge)
-                {
-                    edge=cityGetDist(currCity, j);
-                    tmpIndex=j;
-                }
+            param->minLength=length;
+            param->minStart=k;
+
+            for(int i=0; i<nbCities+1; i++)
+                param->minArr[i]=tour[i];
         }
-        currCity=mapGetCity(m, tmpIndex);
-        visited[i]=tmpIndex;
-        path[i]=currCity;
     }
-    path[nbCities]=c;
-    return path;
+
+    freeArrIndexes(tour);
+    return NULL;
 }
 
 /**
- * \fn City* nearestNeighbour2(Map m, City cityBegin)
- * \brief Fonction qui exécute une seconde version de l'algorithme Nearest Neighbour.
- * \param Map m : Map à laquelle est appliquée l'algorithme.
- * \param City cityBegin : Ville de départ et d'arrivée du chemin.
+ * \fn City* nearestNeighbourMulti(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme Nearest Neighbour depuis plusieurs villes de départ et garde le chemin le plus court.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin (le meilleur chemin est tourné pour partir de c).
  * \return Un chemin sous la forme d'un tableau de City.
+ *
+ * Toutes les villes sont essayées (au plus NN_MULTI_MAX_STARTS, réparties régulièrement, dont c), les départs étant
+ * distribués entre getNbThreads() threads. Le résultat ne dépend pas du nombre de threads : à longueur égale, le
+ * premier départ l'emporte.
  */
 
-City* nearestNeighbour2(Map m, City cityBegin) // seconde version du NN
+City* nearestNeighbourMulti(Map m, City c)
 {
     int nbCities=mapGetSize(m);
-    City* path=arrCitiesCreate(nbCities+1);
-    double minDist;
-    int currentIndex;
-    int iArray[nbCities]; // tableau des indices inclues des villes placées dans le chemin
-    int iCount=0; // nombre de villes placées dans le chemin
-    path[0]=cityBegin;
-    iArray[0]=cityGetIndex(cityBegin);
-    while(iCount<nbCities) // tant qu'on a pas ajouté toutes les villes dans le tableau des indices inclues
+    int nbStarts=nbCities<NN_MULTI_MAX_STARTS ? nbCities : NN_MULTI_MAX_STARTS;
+    int nbThreads=getNbThreads();
+
+    if(nbThreads>nbStarts)
+        nbThreads=nbStarts;
+
+    pthread_t thread[nbThreads];
+    struct nn_params params[nbThreads];
+
+    for(int t=0; t<nbThreads; t++)
     {
-        currentIndex=0;
-        while(isInside(iArray,iCount,currentIndex)) // on cherche le premier indice qui n'est pas dans le tableau des indices inclues
-            currentIndex++;
-        minDist=cityGetDist(mapGetCity(m,currentIndex),iArray[iCount]); // quand on l'a, on prend la distance entre lui et le dernier indice ajouté, ce sera notre base pour calculer la distance minimum
-        for(int i=0; i<nbCities; ++i)
-            if(iArray[iCount]!=i && !isInside(iArray,iCount,i) && cityGetDist(mapGetCity(m,i),iArray[iCount])<minDist) // si la ville n'a pas déjà été inclue et que sa distance avec la dernière ajoutée est inférieure à la distance stockée
-            {
-                minDist=cityGetDist(mapGetCity(m,i),iArray[iCount]);
-                currentIndex=i;
-            }
-        path[iCount+1]=mapGetCity(m,currentIndex); // ajout dans le path
-        iArray[++iCount]=currentIndex; // et ajout dans le tableau des indices inclue
+        params[t].m=m;
+        params[t].first=t;
+        params[t].step=nbThreads;
+        params[t].nbStarts=nbStarts;
+        params[t].sCity=cityGetIndex(c);
+        params[t].minArr=arrIndexesCreate(nbCities+1);
     }
-    path[nbCities]=cityBegin;
+
+    for(int t=1; t<nbThreads; t++)
+        pthread_create(&thread[t], NULL, nearestNeighbour_thread, &params[t]);
+
+    nearestNeighbour_thread(&params[0]);
+
+    for(int t=1; t<nbThreads; t++)
+        pthread_join(thread[t], NULL);
+
+    int best=0;
+
+    for(int t=1; t<nbThreads; t++)
+        if(params[t].minLength<params[best].minLength || (params[t].minLength==params[best].minLength && params[t].minStart<params[best].minStart))
+            best=t;
+
+    int *minArr=params[best].minArr;
+    int offset=0; // position de c dans le meilleur chemin
+
+    while(minArr[offset]!=cityGetIndex(c))
+        offset++;
+
+    City *path=arrCitiesCreate(nbCities+1);
+
+    for(int i=0; i<nbCities; i++)
+        path[i]=mapGetCity(m, minArr[(offset+i)%nbCities]);
+    path[nbCities]=c;
+
+    for(int t=0; t<nbThreads; t++)
+        freeArrIndexes(params[t].minArr);
+
     return path;
 }
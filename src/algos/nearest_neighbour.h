@@ -22,13 +22,14 @@
 City* nearestNeighbour(Map m, City c);
 
 /**
- * \fn City* nearestNeighbour2(Map m, City cityBegin)
- * \brief Fonction qui exécute une seconde version de l'algorithme Nearest Neighbour.
- * \param Map m : Map à laquelle est appliquée l'algorithme.
- * \param City cityBegin : Ville de départ et d'arrivée du chemin.
+ * \fn City* nearestNeighbourMulti(Map m, City c)
+ * \brief Fonction qui exécute l'algorithme Nearest Neighbour depuis plusieurs villes de départ (en parallèle) et garde le chemin le plus court.
+ * \param Map m : Map à laquelle est appliqué l'algorithme.
+ * \param City c : Ville de départ et d'arrivée du chemin.
  * \return Un chemin sous la forme d'un tableau de City.
  */
-City* nearestNeighbour2(Map m, City cityBegin);
+
+City* nearestNeighbourMulti(Map m, City c);
 
 
 #endif // NEAREST_NEIGHBOUR_H_INCLUDED
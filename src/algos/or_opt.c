@@ -0,0 +1,219 @@
+/**
+ * \file or_opt.c
+ * \brief Fichier implémentant l'amélioration Or-opt d'un chemin.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Un mouvement Or-opt déplace un trajet de 1 à OR_OPT_MAX_SEGMENT villes entre deux autres villes voisines dans le
+ * chemin, à l'endroit ou à l'envers. Seules les insertions à côté d'un des plus proches voisins d'une extrémité du
+ * trajet sont essayées, et seulement tant que ce voisin est plus près que le gain du retrait du trajet. Comme pour le
+ * 2-opt, les villes dont le voisinage n'a rien donné ne sont réessayées que si une de leurs arêtes change.
+ *
+ * Le déplacement est fait par deux ou trois mouvements 2-opt successifs sur le chemin (tourMove2).
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "../city.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "tour.h"
+#include "or_opt.h"
+
+/**
+ * \def OR_OPT_NEIGHBOURS
+ * \brief Nombre de plus proches voisins essayés par ville, si la Map n'a pas déjà des listes de voisins.
+ */
+
+#define OR_OPT_NEIGHBOURS 10
+
+/**
+ * \def OR_OPT_MAX_SEGMENT
+ * \brief Nombre maximum de villes d'un trajet déplacé.
+ */
+
+#define OR_OPT_MAX_SEGMENT 3
+
+/**
+ * \def OR_OPT_EPS
+ * \brief Gain minimum d'un mouvement (évite de boucler sur des égalités d'arrondi).
+ */
+
+#define OR_OPT_EPS 1e-9
+
+/**
+ * \fn static int orOptStep(Tour t, int a, bool forward)
+ * \brief Fonction qui retourne la ville suivant a dans un sens de parcours.
+ */
+
+static int orOptStep(Tour t, int a, bool forward)
+{
+    return forward ? tourNext(t, a) : tourPrev(t, a);
+}
+
+/**
+ * \fn static void orOptMove(Tour t, int p, int s1, int s2, int nx, int e1, int e2, bool reversed)
+ * \brief Fonction qui déplace le trajet s1..s2 (entre p et nx) entre e1 et e2.
+ * \param bool reversed : true pour insérer e1 s2 .. s1 e2, false pour e1 s1 .. s2 e2.
+ */
+
+static void orOptMove(Tour t, int p, int s1, int s2, int nx, int e1, int e2, bool reversed)
+{
+    tourMove2(t, p, s1, e1, e2); // p s1..s2 nx..e1 e2 -> p e1..nx s2..s1 e2
+    tourMove2(t, p, e1, nx, s2); // -> p nx..e1 s2..s1 e2
+
+    if(!reversed && s1!=s2)
+        tourMove2(t, e1, s2, s1, e2); // -> p nx..e1 s1..s2 e2
+}
+
+/**
+ * \fn static bool orOptFrom(Map m, Tour t, int a, int *moved)
+ * \brief Fonction qui cherche et applique un mouvement Or-opt gagnant déplaçant un trajet dont a est une extrémité.
+ * \param Map m : Map du chemin.
+ * \param Tour t : Chemin.
+ * \param int a : Ville essayée.
+ * \param int *moved : Rempli avec les 6 villes dont les arêtes ont changé.
+ * \return true si un mouvement a été appliqué.
+ */
+
+static bool orOptFrom(Map m, Tour t, int a, int *moved)
+{
+    int k=mapGetNbNeighbours(m);
+
+    for(int dir=0; dir<2; dir++)
+    {
+        bool forward=dir==0;
+        int s1=a, s2=a;
+        int seg[OR_OPT_MAX_SEGMENT];
+
+        for(int len=1; len<=OR_OPT_MAX_SEGMENT; len++)
+        {
+            if(len>1)
+                s2=orOptStep(t, s2, forward);
+            seg[len-1]=s2;
+
+            int p=orOptStep(t, s1, !forward);
+            int nx=orOptStep(t, s2, forward);
+
+            if(p==s2 || nx==s1 || p==nx)
+                break;
+
+            double gRemove=mapDist(m, p, s1)+mapDist(m, s2, nx)-mapDist(m, p, nx);
+
+            if(gRemove<=OR_OPT_EPS)
+                continue;
+
+            for(int end=0; end<2; end++) // voisins de s1, puis de s2
+            {
+                int s=end==0 ? s1 : s2;
+                const int *nb=mapGetNeighbours(m, s);
+
+                for(int l=0; l<k; l++)
+                {
+                    int c=nb[l];
+
+                    if(mapDist(m, s, c)>=gRemove) // voisins triés : les suivants sont plus loin
+                        break;
+
+                    for(int side=0; side<2; side++) // c avant ou après l'insertion
+                    {
+                        int e1=side==0 ? c : orOptStep(t, c, !forward);
+                        int e2=side==0 ? orOptStep(t, c, forward) : c;
+                        bool inSeg=false;
+
+                        for(int q=0; q<len; q++)
+                            inSeg=inSeg || seg[q]==e1 || seg[q]==e2;
+
+                        if(inSeg || e1==p || e1==nx || e2==p)
+                            continue;
+
+                        // s à côté de c : à l'endroit si s1 touche e1 ou s2 touche e2
+                        bool reversed=(s==s1)!=(c==e1);
+                        double add=reversed ? mapDist(m, e1, s2)+mapDist(m, s1, e2) : mapDist(m, e1, s1)+mapDist(m, s2, e2);
+
+                        if(gRemove-add+mapDist(m, e1, e2)>OR_OPT_EPS)
+                        {
+                            orOptMove(t, p, s1, s2, nx, e1, e2, reversed);
+
+                            moved[0]=p;
+                            moved[1]=s1;
+                            moved[2]=s2;
+                            moved[3]=nx;
+                            moved[4]=e1;
+                            moved[5]=e2;
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * \fn void orOpt(Map m, City *path)
+ * \brief Fonction qui améliore un chemin par des mouvements Or-opt jusqu'à ce qu'aucun ne soit gagnant.
+ * \param Map m : Map du chemin.
+ * \param City *path : Chemin (mapGetSize(m)+1 villes) modifié sur place, sa ville de départ est gardée.
+ * \return void
+ */
+
+void orOpt(Map m, City *path)
+{
+    int n=mapGetSize(m);
+
+    if(n<5)
+        return;
+
+    if(!mapIsSymmetric(m)) // les gains supposent d(i, j) == d(j, i), sinon la recherche peut boucler
+    {
+        throwWarn("OrOpt", "Distances are not symmetric, path left unchanged (orOpt)", NULL);
+        return;
+    }
+
+    if(mapGetNbNeighbours(m)==0)
+        mapBuildNeighbours(m, OR_OPT_NEIGHBOURS);
+
+    Tour t=tourCreate(path, n);
+    int *queue=malloc(n*sizeof(int)); // file circulaire des villes à essayer
+    bool *inQueue=malloc(n*sizeof(bool));
+    int head=0, size=n;
+    int moved[6];
+
+    for(int i=0; i<n; i++)
+    {
+        queue[i]=cityGetIndex(path[i]);
+        inQueue[i]=true;
+    }
+
+    while(size>0)
+    {
+        int a=queue[head];
+
+        if(orOptFrom(m, t, a, moved))
+        {
+            for(int i=0; i<6; i++) // les villes dont une arête a changé sont réessayées (a reste en tête)
+                if(!inQueue[moved[i]])
+                {
+                    inQueue[moved[i]]=true;
+                    queue[(head+size++)%n]=moved[i];
+                }
+            continue;
+        }
+
+        inQueue[a]=false;
+        head=(head+1)%n;
+        size--;
+    }
+
+    tourToPath(t, m, cityGetIndex(path[0]), path);
+
+    free(inQueue);
+    free(queue);
+    tourDelete(t);
+}
@@ -0,0 +1,25 @@
+/**
+ * \file or_opt.h
+ * \brief Fichier d'en-tête de l'amélioration Or-opt d'un chemin.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef OR_OPT_H_INCLUDED
+#define OR_OPT_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn void orOpt(Map m, City *path)
+ * \brief Fonction qui améliore un chemin par des mouvements Or-opt (déplacement de trajets de 1 à 3 villes, listes de voisins, bits "don't look") jusqu'à ce qu'aucun ne soit gagnant.
+ * \param Map m : Map du chemin.
+ * \param City *path : Chemin (mapGetSize(m)+1 villes) modifié sur place, sa ville de départ est gardée.
+ * \return void
+ */
+
+void orOpt(Map m, City *path);
+
+#endif // OR_OPT_H_INCLUDED
@@ -0,0 +1,650 @@
+/**
+ * \file tour.c
+ * \brief Fichier implémentant le chemin modifiable des heuristiques d'amélioration (2-opt, Or-opt...).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Deux représentations sont utilisées selon la taille du chemin :
+ * - jusqu'à TOUR_TWO_LEVEL_MIN villes, un tableau des villes dans l'ordre de parcours et la position de chaque ville
+ *   dans ce tableau : next, prev et between sont en O(1), une inversion coûte la longueur du plus court des deux trajets ;
+ * - au-delà, une liste doublement chaînée à deux niveaux : les villes sont réparties en environ sqrt(n) segments, chacun
+ *   étant une liste chaînée de villes numérotées avec un bit d'inversion, et les segments forment eux-mêmes une liste
+ *   chaînée numérotée. next, prev et between restent en O(1), une inversion coûte O(sqrt(n)) : les segments des extrémités
+ *   sont coupés (la plus petite partie rejoint le segment voisin), puis la suite des segments est inversée en inversant
+ *   leur ordre et leurs bits.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "../city.h"
+#include "../map.h"
+#include "tour.h"
+
+/**
+ * \def TOUR_TWO_LEVEL_MIN
+ * \brief Nombre de villes à partir duquel le chemin est une liste à deux niveaux plutôt qu'un tableau.
+ */
+
+#define TOUR_TWO_LEVEL_MIN 10000
+
+/**
+ * \def TOUR_MAX_ID
+ * \brief Numéro maximum (en valeur absolue) d'une ville dans son segment avant de renuméroter le segment.
+ */
+
+#define TOUR_MAX_ID (1<<30)
+
+/** \struct _Tour
+ *  \brief Structure représentant un chemin modifiable.
+ */
+
+struct _Tour
+{
+    int n; /*!< Nombre de villes. */
+    int *order; /*!< Villes dans l'ordre de parcours (tableau). */
+    int *pos; /*!< Position de chaque ville dans order (tableau). */
+    int nbSegs; /*!< Nombre de segments (liste à deux niveaux), 0 pour un tableau. */
+    int *nx; /*!< Ville suivante dans le segment, dans le sens des numéros (-1 en fin de segment). */
+    int *pv; /*!< Ville précédente dans le segment, dans le sens des numéros (-1 en début de segment). */
+    int *id; /*!< Numéro de chaque ville dans son segment (numéros consécutifs, croissants dans le sens de nx). */
+    int *seg; /*!< Segment de chaque ville. */
+    bool *rev; /*!< Bit d'inversion de chaque segment. */
+    int *head; /*!< Ville de plus petit numéro de chaque segment. */
+    int *tail; /*!< Ville de plus grand numéro de chaque segment. */
+    int *size; /*!< Nombre de villes de chaque segment. */
+    int *snext; /*!< Segment suivant dans le chemin. */
+    int *sprev; /*!< Segment précédent dans le chemin. */
+    int *rank; /*!< Position de chaque segment dans le chemin. */
+    int *buf; /*!< Tableau de travail de n villes. */
+};
+
+/**
+ * \fn static int tlFirst(Tour t, int s)
+ * \brief Fonction qui retourne la première ville du segment s dans le sens du chemin.
+ */
+
+static int tlFirst(Tour t, int s)
+{
+    return t->rev[s] ? t->tail[s] : t->head[s];
+}
+
+/**
+ * \fn static int tlLast(Tour t, int s)
+ * \brief Fonction qui retourne la dernière ville du segment s dans le sens du chemin.
+ */
+
+static int tlLast(Tour t, int s)
+{
+    return t->rev[s] ? t->head[s] : t->tail[s];
+}
+
+/**
+ * \fn static int tlIndex(Tour t, int a)
+ * \brief Fonction qui retourne la position de a dans son segment, dans le sens du chemin.
+ */
+
+static int tlIndex(Tour t, int a)
+{
+    int s=t->seg[a];
+
+    return t->rev[s] ? t->id[t->tail[s]]-t->id[a] : t->id[a]-t->id[t->head[s]];
+}
+
+/**
+ * \fn static long long tlPos(Tour t, int a)
+ * \brief Fonction qui retourne une clé croissante dans le sens du chemin, à partir du segment de rang 0.
+ */
+
+static long long tlPos(Tour t, int a)
+{
+    return (long long)t->rank[t->seg[a]]*t->n+tlIndex(t, a);
+}
+
+/**
+ * \fn static void tlSet(Tour t, int s, const int *cities, int nb)
+ * \brief Fonction qui remplit le segment s avec les villes données dans le sens du chemin (le bit d'inversion est remis à 0).
+ */
+
+static void tlSet(Tour t, int s, const int *cities, int nb)
+{
+    for(int i=0; i<nb; i++)
+    {
+        int a=cities[i];
+
+        t->id[a]=i;
+        t->seg[a]=s;
+        t->pv[a]=i>0 ? cities[i-1] : -1;
+        t->nx[a]=i<nb-1 ? cities[i+1] : -1;
+    }
+
+    t->rev[s]=false;
+    t->head[s]=cities[0];
+    t->tail[s]=cities[nb-1];
+    t->size[s]=nb;
+}
+
+/**
+ * \fn static void tlRenumber(Tour t, int s)
+ * \brief Fonction qui renumérote les villes du segment s à partir de 0.
+ */
+
+static void tlRenumber(Tour t, int s)
+{
+    int i=0;
+
+    for(int a=t->head[s]; a>=0; a=t->nx[a])
+        t->id[a]=i++;
+}
+
+/**
+ * \fn static void tlAddFirst(Tour t, int s, int a)
+ * \brief Fonction qui ajoute la ville a au début du segment s (dans le sens du chemin).
+ */
+
+static void tlAddFirst(Tour t, int s, int a)
+{
+    t->seg[a]=s;
+    t->size[s]++;
+
+    if(!t->rev[s]) // début des numéros
+    {
+        t->pv[a]=-1;
+        t->nx[a]=t->head[s];
+        t->id[a]=t->id[t->head[s]]-1;
+        t->pv[t->head[s]]=a;
+        t->head[s]=a;
+    }
+    else // fin des numéros
+    {
+        t->nx[a]=-1;
+        t->pv[a]=t->tail[s];
+        t->id[a]=t->id[t->tail[s]]+1;
+        t->nx[t->tail[s]]=a;
+        t->tail[s]=a;
+    }
+
+    if(t->id[a]<-TOUR_MAX_ID || t->id[a]>TOUR_MAX_ID)
+        tlRenumber(t, s);
+}
+
+/**
+ * \fn static void tlAddLast(Tour t, int s, int a)
+ * \brief Fonction qui ajoute la ville a à la fin du segment s (dans le sens du chemin).
+ */
+
+static void tlAddLast(Tour t, int s, int a)
+{
+    t->rev[s]=!t->rev[s]; // la fin dans le sens du chemin est le début dans l'autre sens
+    tlAddFirst(t, s, a);
+    t->rev[s]=!t->rev[s];
+}
+
+/**
+ * \fn static void tlSplitBefore(Tour t, int a)
+ * \brief Fonction qui coupe le segment de a pour que a soit la première ville de son segment.
+ *
+ * La plus petite des deux parties rejoint le segment voisin de son côté : a reste dans son segment ou passe au début du
+ * suivant.
+ */
+
+static void tlSplitBefore(Tour t, int a)
+{
+    int s=t->seg[a];
+    int i=tlIndex(t, a);
+
+    if(i==0)
+        return;
+
+    if(2*i<=t->size[s]) // villes avant a à la fin du segment précédent
+    {
+        int sp=t->sprev[s];
+        int b=tlFirst(t, s);
+
+        for(int j=0; j<i; j++)
+        {
+            t->buf[j]=b;
+            b=t->rev[s] ? t->pv[b] : t->nx[b];
+        }
+
+        if(t->rev[s])
+        {
+            t->tail[s]=a;
+            t->nx[a]=-1;
+        }
+        else
+        {
+            t->head[s]=a;
+            t->pv[a]=-1;
+        }
+
+        t->size[s]-=i;
+
+        for(int j=0; j<i; j++)
+            tlAddLast(t, sp, t->buf[j]);
+    }
+    else // villes à partir de a au début du segment suivant
+    {
+        int sn=t->snext[s];
+        int nb=t->size[s]-i;
+        int b=a;
+        int last=t->rev[s] ? t->nx[a] : t->pv[a];
+
+        for(int j=0; j<nb; j++)
+        {
+            t->buf[j]=b;
+            b=t->rev[s] ? t->pv[b] : t->nx[b];
+        }
+
+        if(t->rev[s])
+        {
+            t->head[s]=last;
+            t->pv[last]=-1;
+        }
+        else
+        {
+            t->tail[s]=last;
+            t->nx[last]=-1;
+        }
+
+        t->size[s]-=nb;
+
+        for(int j=nb-1; j>=0; j--)
+            tlAddFirst(t, sn, t->buf[j]);
+    }
+}
+
+/**
+ * \fn static void tlSplitAfter(Tour t, int b)
+ * \brief Fonction qui coupe le segment de b pour que b soit la dernière ville de son segment.
+ */
+
+static void tlSplitAfter(Tour t, int b)
+{
+    int s=t->seg[b];
+
+    if(b!=tlLast(t, s))
+        tlSplitBefore(t, t->rev[s] ? t->pv[b] : t->nx[b]);
+}
+
+/**
+ * \fn static bool tlInSegment(Tour t, int a, int b)
+ * \brief Fonction qui indique si le trajet de a à b est contenu dans un seul segment.
+ */
+
+static bool tlInSegment(Tour t, int a, int b)
+{
+    return t->seg[a]==t->seg[b] && tlIndex(t, a)<=tlIndex(t, b);
+}
+
+/**
+ * \fn static void tlFlipInSegment(Tour t, int a, int b)
+ * \brief Fonction qui inverse le trajet de a à b, contenu dans un seul segment (en place, en renumérotant ses villes).
+ */
+
+static void tlFlipInSegment(Tour t, int a, int b)
+{
+    int s=t->seg[a];
+    int x=t->rev[s] ? b : a, y=t->rev[s] ? a : b; // x avant y dans le sens des numéros
+    int before=t->pv[x], after=t->nx[y];
+    int lo=t->id[x];
+    int nb=0;
+
+    for(int c=x; c!=after; c=t->nx[c])
+        t->buf[nb++]=c;
+
+    for(int k=0; k<nb; k++)
+    {
+        int c=t->buf[nb-1-k];
+
+        t->id[c]=lo+k;
+        t->pv[c]=k==0 ? before : t->buf[nb-k];
+        t->nx[c]=k==nb-1 ? after : t->buf[nb-2-k];
+    }
+
+    if(before>=0)
+        t->nx[before]=y;
+    else
+        t->head[s]=y;
+
+    if(after>=0)
+        t->pv[after]=x;
+    else
+        t->tail[s]=x;
+}
+
+/**
+ * \fn static void tlFlip(Tour t, int a, int b)
+ * \brief Fonction qui inverse le trajet de a à b (voir tourFlip) dans une liste à deux niveaux.
+ */
+
+static void tlFlip(Tour t, int a, int b)
+{
+    if(a==b)
+        return;
+
+    if(tlInSegment(t, a, b))
+    {
+        tlFlipInSegment(t, a, b);
+        return;
+    }
+
+    int sa=t->seg[a], sb=t->seg[b];
+    int nb=sa==sb ? t->nbSegs+1 : (t->rank[sb]-t->rank[sa]+t->nbSegs)%t->nbSegs+1; // segments touchés
+
+    if(2*nb>t->nbSegs) // le complément touche moins de segments : inverser next(b)..prev(a) donne le même cycle
+    {
+        int c=tourNext(t, b), d=tourPrev(t, a);
+
+        if(c==a) // trajet de tout le chemin
+            return;
+
+        a=c;
+        b=d;
+
+        if(tlInSegment(t, a, b))
+        {
+            tlFlipInSegment(t, a, b);
+            return;
+        }
+    }
+
+    tlSplitBefore(t, a);
+    tlSplitAfter(t, b);
+
+    if(tlInSegment(t, a, b)) // les coupes ont pu rassembler le trajet dans un segment
+    {
+        tlFlipInSegment(t, a, b);
+        return;
+    }
+
+    // a commence et b termine une suite de segments : leur ordre et leurs bits sont inversés
+    sa=t->seg[a];
+    sb=t->seg[b];
+
+    int p=t->sprev[sa], q=t->snext[sb];
+    int r=t->rank[sa];
+    int k=0;
+
+    for(int s=sa; ; s=t->snext[s])
+    {
+        t->buf[k++]=s;
+        if(s==sb)
+            break;
+    }
+
+    for(int i=0; i<k; i++)
+    {
+        int s=t->buf[k-1-i];
+
+        t->rev[s]=!t->rev[s];
+        t->rank[s]=(r+i)%t->nbSegs;
+        t->sprev[s]=i==0 ? p : t->buf[k-i];
+        t->snext[s]=i==k-1 ? q : t->buf[k-2-i];
+    }
+
+    t->snext[p]=sb;
+    t->sprev[q]=sa;
+}
+
+/**
+ * \fn Tour tourCreate(const City *path, int n)
+ * \brief Fonction qui crée un chemin modifiable à partir d'un chemin sous forme de tableau de City.
+ * \param const City *path : Chemin (n villes, la ville de départ répétée à la fin est ignorée).
+ * \param int n : Nombre de villes.
+ * \return Le chemin.
+ */
+
+Tour tourCreate(const City *path, int n)
+{
+    Tour t=calloc(1, sizeof(struct _Tour));
+
+    t->n=n;
+
+    if(n<TOUR_TWO_LEVEL_MIN)
+    {
+        t->order=malloc(n*sizeof(int));
+        t->pos=malloc(n*sizeof(int));
+
+        for(int i=0; i<n; i++)
+        {
+            t->order[i]=cityGetIndex(path[i]);
+            t->pos[t->order[i]]=i;
+        }
+
+        return t;
+    }
+
+    int nbSegs=1;
+
+    while(nbSegs*nbSegs<n)
+        nbSegs++;
+
+    t->nbSegs=nbSegs;
+    t->nx=malloc(n*sizeof(int));
+    t->pv=malloc(n*sizeof(int));
+    t->id=malloc(n*sizeof(int));
+    t->seg=malloc(n*sizeof(int));
+    t->buf=malloc(n*sizeof(int));
+    t->rev=malloc(nbSegs*sizeof(bool));
+    t->head=malloc(nbSegs*sizeof(int));
+    t->tail=malloc(nbSegs*sizeof(int));
+    t->size=malloc(nbSegs*sizeof(int));
+    t->snext=malloc(nbSegs*sizeof(int));
+    t->sprev=malloc(nbSegs*sizeof(int));
+    t->rank=malloc(nbSegs*sizeof(int));
+
+    for(int i=0; i<n; i++)
+        t->buf[i]=cityGetIndex(path[i]);
+
+    for(int s=0; s<nbSegs; s++)
+    {
+        int from=(long long)s*n/nbSegs, to=(long long)(s+1)*n/nbSegs;
+
+        tlSet(t, s, t->buf+from, to-from);
+        t->rank[s]=s;
+        t->snext[s]=(s+1)%nbSegs;
+        t->sprev[s]=(s+nbSegs-1)%nbSegs;
+    }
+
+    return t;
+}
+
+/**
+ * \fn void tourDelete(Tour t)
+ * \brief Fonction qui libère un chemin.
+ * \param Tour t : Chemin à libérer.
+ * \return void
+ */
+
+void tourDelete(Tour t)
+{
+    free(t->pos);
+    free(t->order);
+    free(t->nx);
+    free(t->pv);
+    free(t->id);
+    free(t->seg);
+    free(t->buf);
+    free(t->rev);
+    free(t->head);
+    free(t->tail);
+    free(t->size);
+    free(t->snext);
+    free(t->sprev);
+    free(t->rank);
+    free(t);
+}
+
+/**
+ * \fn void tourToPath(Tour t, Map m, int start, City *path)
+ * \brief Fonction qui écrit le chemin sous forme de tableau de City, en partant de la ville start.
+ * \param Tour t : Chemin.
+ * \param Map m : Map des villes.
+ * \param int start : Ville de départ et d'arrivée.
+ * \param City *path : Tableau de n+1 City à remplir.
+ * \return void
+ */
+
+void tourToPath(Tour t, Map m, int start, City *path)
+{
+    if(t->nbSegs>0)
+    {
+        int a=start;
+
+        for(int i=0; i<t->n; i++)
+        {
+            path[i]=mapGetCity(m, a);
+            a=tourNext(t, a);
+        }
+
+        path[t->n]=path[0];
+        return;
+    }
+
+    int p=t->pos[start];
+
+    for(int i=0; i<t->n; i++)
+    {
+        path[i]=mapGetCity(m, t->order[p]);
+        if(++p==t->n)
+            p=0;
+    }
+
+    path[t->n]=path[0];
+}
+
+/**
+ * \fn int tourNext(Tour t, int a)
+ * \brief Fonction qui retourne la ville suivant a dans le chemin.
+ */
+
+int tourNext(Tour t, int a)
+{
+    if(t->nbSegs>0)
+    {
+        int s=t->seg[a];
+        int b=t->rev[s] ? t->pv[a] : t->nx[a];
+
+        return b>=0 ? b : tlFirst(t, t->snext[s]);
+    }
+
+    int p=t->pos[a]+1;
+
+    return t->order[p==t->n ? 0 : p];
+}
+
+/**
+ * \fn int tourPrev(Tour t, int a)
+ * \brief Fonction qui retourne la ville précédant a dans le chemin.
+ */
+
+int tourPrev(Tour t, int a)
+{
+    if(t->nbSegs>0)
+    {
+        int s=t->seg[a];
+        int b=t->rev[s] ? t->nx[a] : t->pv[a];
+
+        return b>=0 ? b : tlLast(t, t->sprev[s]);
+    }
+
+    int p=t->pos[a];
+
+    return t->order[p==0 ? t->n-1 : p-1];
+}
+
+/**
+ * \fn bool tourBetween(Tour t, int a, int b, int c)
+ * \brief Fonction qui indique si b est sur le trajet de a à c dans le sens du chemin (a et c compris).
+ */
+
+bool tourBetween(Tour t, int a, int b, int c)
+{
+    long long pa, pb, pc;
+
+    if(t->nbSegs>0)
+    {
+        pa=tlPos(t, a);
+        pb=tlPos(t, b);
+        pc=tlPos(t, c);
+    }
+    else
+    {
+        pa=t->pos[a];
+        pb=t->pos[b];
+        pc=t->pos[c];
+    }
+
+    if(pa<=pc)
+        return pa<=pb && pb<=pc;
+
+    return pb>=pa || pb<=pc;
+}
+
+/**
+ * \fn void tourFlip(Tour t, int a, int b)
+ * \brief Fonction qui inverse le trajet de a à b (dans le sens du chemin) : les arêtes (prev(a), a) et (b, next(b)) sont remplacées par (prev(a), b) et (a, next(b)).
+ * \param Tour t : Chemin.
+ * \param int a : Première ville du trajet.
+ * \param int b : Dernière ville du trajet.
+ * \return void
+ */
+
+void tourFlip(Tour t, int a, int b)
+{
+    if(t->nbSegs>0)
+    {
+        tlFlip(t, a, b);
+        return;
+    }
+
+    int i=t->pos[a], j=t->pos[b];
+    int len=j-i+1; // nombre de villes du trajet
+
+    if(len<=0)
+        len+=t->n;
+
+    if(2*len>t->n) // le complément est plus court : inverser next(b)..prev(a) donne le même cycle
+    {
+        int tmp=i;
+        i=j+1==t->n ? 0 : j+1;
+        j=tmp==0 ? t->n-1 : tmp-1;
+        len=t->n-len;
+    }
+
+    for(int k=0; k<len/2; k++)
+    {
+        int ci=t->order[i], cj=t->order[j];
+
+        t->order[i]=cj;
+        t->pos[cj]=i;
+        t->order[j]=ci;
+        t->pos[ci]=j;
+
+        if(++i==t->n)
+            i=0;
+        if(--j<0)
+            j=t->n-1;
+    }
+}
+
+/**
+ * \fn void tourMove2(Tour t, int a, int b, int c, int d)
+ * \brief Fonction qui applique un mouvement 2-opt : les arêtes (a, b) et (c, d) sont remplacées par (a, c) et (b, d).
+ * \param Tour t : Chemin.
+ * \param int a : Ville de la première arête.
+ * \param int b : Voisine de a, suivante ou précédente.
+ * \param int c : Ville de la seconde arête.
+ * \param int d : Voisine de c, dans le même sens que b pour a.
+ * \return void
+ */
+
+void tourMove2(Tour t, int a, int b, int c, int d)
+{
+    if(tourNext(t, a)==b)
+        tourFlip(t, b, c); // a b ... c d -> a c ... b d
+    else
+        tourFlip(t, a, d); // b a ... d c -> b d ... a c
+}
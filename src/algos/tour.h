@@ -0,0 +1,98 @@
+/**
+ * \file tour.h
+ * \brief Fichier d'en-tête du chemin modifiable des heuristiques d'amélioration (2-opt, Or-opt...).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef TOUR_H
+#define TOUR_H
+
+#include <stdbool.h>
+
+#include "../city.h"
+#include "../map.h"
+
+typedef struct _Tour * Tour;
+
+/**
+ * \fn Tour tourCreate(const City *path, int n)
+ * \brief Fonction qui crée un chemin modifiable à partir d'un chemin sous forme de tableau de City.
+ * \param const City *path : Chemin (n villes, la ville de départ répétée à la fin est ignorée).
+ * \param int n : Nombre de villes.
+ * \return Le chemin.
+ */
+
+Tour tourCreate(const City *path, int n);
+
+/**
+ * \fn void tourDelete(Tour t)
+ * \brief Fonction qui libère un chemin.
+ * \param Tour t : Chemin à libérer.
+ * \return void
+ */
+
+void tourDelete(Tour t);
+
+/**
+ * \fn void tourToPath(Tour t, Map m, int start, City *path)
+ * \brief Fonction qui écrit le chemin sous forme de tableau de City, en partant de la ville start.
+ * \param Tour t : Chemin.
+ * \param Map m : Map des villes.
+ * \param int start : Ville de départ et d'arrivée.
+ * \param City *path : Tableau de n+1 City à remplir.
+ * \return void
+ */
+
+void tourToPath(Tour t, Map m, int start, City *path);
+
+/**
+ * \fn int tourNext(Tour t, int a)
+ * \brief Fonction qui retourne la ville suivant a dans le chemin.
+ */
+
+int tourNext(Tour t, int a);
+
+/**
+ * \fn int tourPrev(Tour t, int a)
+ * \brief Fonction qui retourne la ville précédant a dans le chemin.
+ */
+
+int tourPrev(Tour t, int a);
+
+/**
+ * \fn bool tourBetween(Tour t, int a, int b, int c)
+ * \brief Fonction qui indique si b est sur le trajet de a à c dans le sens du chemin (a et c compris).
+ */
+
+bool tourBetween(Tour t, int a, int b, int c);
+
+/**
+ * \fn void tourFlip(Tour t, int a, int b)
+ * \brief Fonction qui inverse le trajet de a à b (dans le sens du chemin) : les arêtes (prev(a), a) et (b, next(b)) sont remplacées par (prev(a), b) et (a, next(b)).
+ * \param Tour t : Chemin.
+ * \param int a : Première ville du trajet.
+ * \param int b : Dernière ville du trajet.
+ * \return void
+ *
+ * Le chemin étant un cycle, c'est le plus court du trajet et de son complément qui est inversé : le cycle obtenu est le
+ * même, mais son sens de parcours peut changer.
+ */
+
+void tourFlip(Tour t, int a, int b);
+
+/**
+ * \fn void tourMove2(Tour t, int a, int b, int c, int d)
+ * \brief Fonction qui applique un mouvement 2-opt : les arêtes (a, b) et (c, d) sont remplacées par (a, c) et (b, d).
+ * \param Tour t : Chemin.
+ * \param int a : Ville de la première arête.
+ * \param int b : Voisine de a, suivante ou précédente.
+ * \param int c : Ville de la seconde arête.
+ * \param int d : Voisine de c, dans le même sens que b pour a.
+ * \return void
+ */
+
+void tourMove2(Tour t, int a, int b, int c, int d);
+
+#endif
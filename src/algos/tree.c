@@ -4,171 +4,122 @@
  * \author Nicolas Marcy
  * \version
  * \date 2014
+ *
+ * L'arbre est rangé à plat : un tableau des pères et les fils de chaque sommet contigus dans un seul tableau (format CSR),
+ * soit trois allocations quelle que soit sa taille. Le parcours utilise une pile explicite, il ne dépend donc pas de la
+ * profondeur de l'arbre (un arbre couvrant de points peut être un long chemin).
  */
 
 #include <stdlib.h>
-#include <stdio.h>
 
 #include "tree.h"
 
-/**
-* \def NB_SONS_MAX_DEFAULT
-* \brief Nombre de fils maximum fixé pour les sommets de l'arbre, utilisé pour la création du tableau des fils qui peut être étendu si besoin.
-*/
-
-#define NB_SONS_MAX_DEFAULT 3
-
 /**
 * \struct Tree tree.h
-* \brief Structure représentant un arbre mathématique. Tree est composé d'un pointeur sur un sommet courant et d'un tableau stockant tous les sommets de l'arbre.
+* \brief Structure représentant un arbre mathématique : les fils du sommet i sont sons[first[i]] à sons[first[i+1]-1].
 */
 
 struct Tree
 {
-    Top currentTop; /*!< Sommet pointé. */
-    Top* arrayTops; /*!< Tableau de pointeurs de sommets stockant tous les sommets de l'abre. */
-    int indexArray; /*!< Nombre de sommets dans le tableau (c'est-à-dire ajoutés à l'arbre). */
-    int nbTops; /*!< Nombre de sommets total. */
-};
-
-/**
-* \struct Top tree.h
-* \brief Structure représentant un sommet d'arbre mathématique. Les sommets sont reliés par "chaînage", c'est-à-dire un pointeur vers un père et un tableau de pointeurs vers des fils.
-*/
-
-struct Top
-{
-    int indice; /*!< Indice du sommet (de 0 à nbTops-1). */
-    int nbSons; /*!< Nombre de fils du sommet. */
-    int nbSonsMax; /*!< Nombre de fils maximum du sommet, défini au début par NB_SONS_MAX_DEFAULT. */
-    Top* sons; /*!< Tableau de pointeurs vers les sommets fils. */
-    Top father; /*!< Pointeur vers le sommet père */
+    int nbTops; /*!< Nombre de sommets. */
+    int root; /*!< Indice de la racine. */
+    int* fathers; /*!< Père de chaque sommet (-1 pour la racine). */
+    int* first; /*!< Début des fils de chaque sommet dans sons (nbTops+1 cases). */
+    int* sons; /*!< Fils de tous les sommets, sommet par sommet. */
 };
 
 /**
-* \fn Tree createTree(int size)
-* \brief Fonction de création et d'initialisation de l'abre.
-* \param size Taille de l'arbre, c'est-à-dire le nombre de sommets de l'arbre.
+* \fn Tree createTree(int size, int root, const int *fathers, const int *sons)
+* \brief Fonction de création de l'arbre à partir de la liste de ses arêtes.
+* \param int size : Taille de l'arbre, c'est-à-dire le nombre de sommets de l'arbre. Les indices des sommets vont de 0 à size-1.
+* \param int root : Indice de la racine.
+* \param const int *fathers : Père de chaque arête (size-1 cases).
+* \param const int *sons : Fils de chaque arête (size-1 cases). Les fils d'un sommet sont rangés dans l'ordre de ce tableau.
 * \return Nouvelle instance d'un Tree.
 */
 
-Tree createTree(int size)
+Tree createTree(int size, int root, const int *fathers, const int *sons)
 {
     Tree T=malloc(sizeof(struct Tree));
-    T->arrayTops=malloc(sizeof(Top)*size);
-    T->indexArray=0;
-    T->currentTop=NULL;
-    T->nbTops=0;
-    return T;
-}
+    T->nbTops=size;
+    T->root=root;
+    T->fathers=malloc(sizeof(int)*size);
+    T->first=calloc(size+1, sizeof(int));
+    T->sons=malloc(sizeof(int)*(size>1 ? size-1 : 1));
+
+    T->fathers[root]=-1;
+    for(int e=0; e<size-1; e++) // nombre de fils de chaque sommet, décalé d'une case
+    {
+        T->fathers[sons[e]]=fathers[e];
+        T->first[fathers[e]+1]++;
+    }
 
-/**
-* \fn Top createTop(int indice)
-* \brief Fonction de création et d'initialisation d'un sommet de l'arbre.
-* \param int indice : Indice du sommet.
-* \return Nouvelle instance d'un Top.
-*/
+    for(int i=0; i<size; i++) // sommes cumulées : first[i+1] est la fin des fils de i
+        T->first[i+1]+=T->first[i];
 
-static Top createTop(int indice)
-{
-    Top t=malloc(sizeof(struct Top));
-    t->indice=indice;
-    t->nbSons=0;
-    t->nbSonsMax=NB_SONS_MAX_DEFAULT;
-    t->sons=malloc(sizeof(Top)*NB_SONS_MAX_DEFAULT);
-    return t;
-}
+    for(int e=0; e<size-1; e++) // first[i] avance jusqu'à la fin des fils de i pendant le remplissage
+        T->sons[T->first[fathers[e]]++]=sons[e];
 
-/**
-* \fn void addTopToTree(Tree T, int iBegin, int iEnd)
-* \brief Fonction d'ajout d'un sommet à l'arbre.
-* \param Tree T : Arbre auquel on ajout le sommet.
-* \param int iBegin : Indice du sommet père auquel on ajoute un fils.
-* \param int iEnd : Indice du sommet fils que l'on ajoute à l'arbre.
-* \return void
-*/
+    for(int i=size; i>0; i--) // on redécale pour retrouver les débuts
+        T->first[i]=T->first[i-1];
+    T->first[0]=0;
 
-void addTopToTree(Tree T, int iBegin, int iEnd)
-{
-    Top t=createTop(iEnd);
-    if (T->currentTop==NULL) // si c'est le premier sommet qu'on ajoute
-        t->father=NULL;
-    else
-    {
-        for(int i=0; i<T->indexArray; i++) // on cherche le sommet de départ de l'arête dans le tableau des sommets
-            if(T->arrayTops[i]->indice==iBegin)
-                T->currentTop=T->arrayTops[i]; // on pointe vers lui pour lui ajouter un fils
-        t->father=T->currentTop;
-        if (T->currentTop->nbSons>=T->currentTop->nbSonsMax) // si tableau des fils plein
-        {
-            T->currentTop->nbSonsMax*=2;
-            T->currentTop->sons=realloc(T->currentTop->sons,sizeof(Top)*T->currentTop->nbSonsMax); // augmentation de la taille du tableau des fils
-        }
-        T->currentTop->sons[T->currentTop->nbSons++]=t;
-    }
-    T->arrayTops[T->indexArray++]=t; // on ajoute ce sommet au tableau des sommets
-    T->currentTop=t; // l'abre pointe désormais sur ce nouveau sommet
+    return T;
 }
 
 /**
-* \fn void upToRoot(Tree T)
-* \brief Fonction qui remonte le pointeur de la structure Tree à la racine de l'arbre.
-* \param Tree T : Arbre concerné.
+* \fn destroyTree(Tree T)
+* \brief Fonction pour libérer la mémoire allouée par l'arbre.
+* \param T Arbre à détruire.
 * \return void
 */
 
-void upToRoot(Tree T)
+void destroyTree(Tree T)
 {
-    while(T->currentTop->father!=NULL)
-        T->currentTop=T->currentTop->father;
+    free(T->sons);
+    free(T->first);
+    free(T->fathers);
+    free(T);
 }
 
 /**
-* \fn static void destroyTops(Top t)
-* \brief Fonction utilisée par la fonction destroyTree pour libérer récursivement la mémoire allouée pour les sommets de l'arbre.
-* \param Top t : Racine de l'arbre ou du sous-arbre à détruire. (Pour libérer tous les sommets d'un arbre, la racine de l'arbre doit être passée en paramètre à l'appel de cette fonction.)
-* \return void
+* \fn int treeGetFather(Tree T, int indice)
+* \brief Fonction qui retourne le père d'un sommet.
+* \param Tree T : Arbre concerné.
+* \param int indice : Indice du sommet.
+* \return Indice du père, -1 pour la racine.
 */
 
-static void destroyTops(Top t)
+int treeGetFather(Tree T, int indice)
 {
-    for(int i=0; i<t->nbSons; i++)
-        destroyTops(t->sons[i]);
-    free(t->sons);
-    free(t);
+    return T->fathers[indice];
 }
 
 /**
-* \fn destroyTree(Tree T)
-* \brief Fonction pour libérer la mémoire allouée par l'arbre et ses sommets.
-* \param T Arbre à détruire.
+* \fn void fillIndexesArrayFromTree(Tree T, int* iPath)
+* \brief Fonction qui remplit un tableau d'indices par un parcours préfixe de l'arbre depuis sa racine.
+* \param Tree T : Arbre à parcourir.
+* \param int* iPath : Tableau de size indices à remplir.
 * \return void
+*
+* Les fils sont empilés du dernier au premier pour être visités dans leur ordre, comme par le parcours récursif.
 */
 
-void destroyTree(Tree T)
+void fillIndexesArrayFromTree(Tree T, int* iPath)
 {
-    upToRoot(T);
-    destroyTops(T->currentTop);
-    free(T->arrayTops);
-    free(T);
-}
+    int* stack=malloc(sizeof(int)*T->nbTops); // chaque sommet n'est empilé qu'une fois
+    int top=0;
 
-/**
-* \fn void fillIndexesArrayFromTree(Tree T, int** iPath)
-* \brief Fonction récursive qui remplit un tableau d'indices à partir de l'arbre passé en paramètre.
-* \param Tree T Arbre à parcourir.
-* \param int** iPath Pointeur sur tableau d'indices à remplir. (On utilise un pointeur sur tableau pour avoir une adresse qui ne change jamais à chaque appel récursif.)
-* \return void
-*/
+    stack[top++]=T->root;
 
-void fillIndexesArrayFromTree(Tree T, int** iPath)
-{
-    **iPath=T->currentTop->indice;
-    (*iPath)++;
-    Top currentTop=T->currentTop; // on sauvegarde le sommet courant pour ne pas le perdre car il change après
-    for(int i=0; i<currentTop->nbSons; ++i)
+    while(top>0)
     {
-        T->currentTop=currentTop->sons[i];
-        fillIndexesArrayFromTree(T,iPath); // on descend vers les fils jusqu'aux feuilles de l'arbre
+        int current=stack[--top];
+        *iPath++=current;
+
+        for(int s=T->first[current+1]-1; s>=T->first[current]; s--)
+            stack[top++]=T->sons[s];
     }
+
+    free(stack);
 }
@@ -9,53 +9,47 @@
 #ifndef TREE_H_INCLUDED
 #define TREE_H_INCLUDED
 
-typedef struct Top* Top;
-typedef struct Tree* Tree;
+typedef struct Tree* Tree;
 
 /**
-* \fn Tree createTree(int size)
-* \brief Fonction de création et d'initialisation de l'abre.
-* \param size Taille de l'arbre, c'est-à-dire le nombre de sommets de l'arbre.
+* \fn Tree createTree(int size, int root, const int *fathers, const int *sons)
+* \brief Fonction de création de l'arbre à partir de la liste de ses arêtes.
+* \param int size : Taille de l'arbre, c'est-à-dire le nombre de sommets de l'arbre. Les indices des sommets vont de 0 à size-1.
+* \param int root : Indice de la racine.
+* \param const int *fathers : Père de chaque arête (size-1 cases).
+* \param const int *sons : Fils de chaque arête (size-1 cases). Les fils d'un sommet sont rangés dans l'ordre de ce tableau.
 * \return Nouvelle instance d'un Tree.
 */
-Tree createTree(int);
-/**
-* \fn destroyTree(Tree T)
-* \brief Fonction pour libérer la mémoire allouée par l'arbre et ses sommets.
-* \param T Arbre à détruire.
-* \return void
-*/
 
-void destroyTree(Tree);
+Tree createTree(int size, int root, const int *fathers, const int *sons);
 
 /**
-* \fn void addTopToTree(Tree T, int iBegin, int iEnd)
-* \brief Fonction d'ajout d'un sommet à l'arbre.
-* \param Tree T : Arbre auquel on ajout le sommet.
-* \param int iBegin : Indice du sommet père auquel on ajoute un fils.
-* \param int iEnd : Indice du sommet fils que l'on ajoute à l'arbre.
+* \fn destroyTree(Tree T)
+* \brief Fonction pour libérer la mémoire allouée par l'arbre.
+* \param T Arbre à détruire.
 * \return void
-*/
+*/
 
-void addTopToTree(Tree,int,int);
+void destroyTree(Tree);
 
 /**
-* \fn void upToRoot(Tree T)
-* \brief Fonction qui remonte le pointeur de la structure Tree à la racine de l'arbre.
+* \fn int treeGetFather(Tree T, int indice)
+* \brief Fonction qui retourne le père d'un sommet.
 * \param Tree T : Arbre concerné.
-* \return void
-*/
+* \param int indice : Indice du sommet.
+* \return Indice du père, -1 pour la racine.
+*/
 
-void upToRoot(Tree);
+int treeGetFather(Tree T, int indice);
 
 /**
-* \fn void fillIndexesArrayFromTree(Tree T, int** iPath)
-* \brief Fonction récursive qui remplit un tableau d'indices à partir de l'arbre passé en paramètre.
-* \param Tree T Arbre à parcourir.
-* \param int** iPath Pointeur sur tableau d'indices à remplir. (On utilise un pointeur sur tableau pour avoir une adresse qui ne change jamais à chaque appel récursif.)
+* \fn void fillIndexesArrayFromTree(Tree T, int* iPath)
+* \brief Fonction qui remplit un tableau d'indices par un parcours préfixe de l'arbre depuis sa racine.
+* \param Tree T : Arbre à parcourir.
+* \param int* iPath : Tableau de size indices à remplir.
 * \return void
-*/
+*/
 
-void fillIndexesArrayFromTree(Tree, int**);
+void fillIndexesArrayFromTree(Tree T, int* iPath);
 
 #endif
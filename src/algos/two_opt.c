@@ -0,0 +1,149 @@
+/**
+ * \file two_opt.c
+ * \brief Fichier implémentant l'amélioration 2-opt d'un chemin.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Un mouvement 2-opt remplace deux arêtes (a, b) et (c, d) par (a, c) et (b, d) en inversant le trajet de b à c.
+ * Pour chaque ville a, seules les villes c de sa liste de plus proches voisins sont essayées, et seulement tant que
+ * d(a, c) est plus petit que l'arête (a, b) quittée (sinon le mouvement ne peut pas être gagnant). Les villes dont le
+ * voisinage n'a rien donné ne sont plus essayées tant qu'une de leurs arêtes ne change pas (bits "don't look") : les
+ * villes à essayer sont gardées dans une file.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "../city.h"
+#include "../map.h"
+#include "../fcts.h"
+#include "algos.h"
+#include "tour.h"
+#include "two_opt.h"
+
+/**
+ * \def TWO_OPT_NEIGHBOURS
+ * \brief Nombre de plus proches voisins essayés par ville, si la Map n'a pas déjà des listes de voisins.
+ */
+
+#define TWO_OPT_NEIGHBOURS 10
+
+/**
+ * \def TWO_OPT_EPS
+ * \brief Gain minimum d'un mouvement (évite de boucler sur des égalités d'arrondi).
+ */
+
+#define TWO_OPT_EPS 1e-9
+
+/**
+ * \fn static bool twoOptFrom(Map m, Tour t, int a, int *moved)
+ * \brief Fonction qui cherche et applique un mouvement 2-opt gagnant retirant une des deux arêtes de a.
+ * \param Map m : Map du chemin.
+ * \param Tour t : Chemin.
+ * \param int a : Ville essayée.
+ * \param int *moved : Rempli avec les 4 villes dont les arêtes ont changé.
+ * \return true si un mouvement a été appliqué.
+ */
+
+static bool twoOptFrom(Map m, Tour t, int a, int *moved)
+{
+    const int *nb=mapGetNeighbours(m, a);
+    int k=mapGetNbNeighbours(m);
+
+    for(int dir=0; dir<2; dir++) // arête vers la suivante, puis vers la précédente
+    {
+        int b=dir==0 ? tourNext(t, a) : tourPrev(t, a);
+        double dab=mapDist(m, a, b);
+
+        for(int l=0; l<k; l++)
+        {
+            int c=nb[l];
+            double g1=dab-mapDist(m, a, c);
+
+            if(g1<=TWO_OPT_EPS) // voisins triés : les suivants sont plus loin
+                break;
+
+            int d=dir==0 ? tourNext(t, c) : tourPrev(t, c);
+
+            if(c==b || d==a)
+                continue;
+
+            if(g1+mapDist(m, c, d)-mapDist(m, b, d)>TWO_OPT_EPS)
+            {
+                tourMove2(t, a, b, c, d);
+
+                moved[0]=a;
+                moved[1]=b;
+                moved[2]=c;
+                moved[3]=d;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * \fn void twoOpt(Map m, City *path)
+ * \brief Fonction qui améliore un chemin par des mouvements 2-opt jusqu'à ce qu'aucun ne soit gagnant.
+ * \param Map m : Map du chemin.
+ * \param City *path : Chemin (mapGetSize(m)+1 villes) modifié sur place, sa ville de départ est gardée.
+ * \return void
+ */
+
+void twoOpt(Map m, City *path)
+{
+    int n=mapGetSize(m);
+
+    if(n<4)
+        return;
+
+    if(!mapIsSymmetric(m)) // le gain d'un mouvement suppose d(i, j) == d(j, i), sinon la recherche peut boucler
+    {
+        throwWarn("TwoOpt", "Distances are not symmetric, path left unchanged (twoOpt)", NULL);
+        return;
+    }
+
+    if(mapGetNbNeighbours(m)==0)
+        mapBuildNeighbours(m, TWO_OPT_NEIGHBOURS);
+
+    Tour t=tourCreate(path, n);
+    int *queue=malloc(n*sizeof(int)); // file circulaire des villes à essayer
+    bool *inQueue=malloc(n*sizeof(bool));
+    int head=0, size=n;
+    int moved[4];
+
+    for(int i=0; i<n; i++)
+    {
+        queue[i]=cityGetIndex(path[i]);
+        inQueue[i]=true;
+    }
+
+    while(size>0)
+    {
+        int a=queue[head];
+
+        if(twoOptFrom(m, t, a, moved))
+        {
+            for(int i=0; i<4; i++) // les villes dont une arête a changé sont réessayées (a reste en tête)
+                if(!inQueue[moved[i]])
+                {
+                    inQueue[moved[i]]=true;
+                    queue[(head+size++)%n]=moved[i];
+                }
+            continue;
+        }
+
+        inQueue[a]=false;
+        head=(head+1)%n;
+        size--;
+    }
+
+    tourToPath(t, m, cityGetIndex(path[0]), path);
+
+    free(inQueue);
+    free(queue);
+    tourDelete(t);
+}
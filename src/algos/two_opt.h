@@ -0,0 +1,25 @@
+/**
+ * \file two_opt.h
+ * \brief Fichier d'en-tête de l'amélioration 2-opt d'un chemin.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef TWO_OPT_H_INCLUDED
+#define TWO_OPT_H_INCLUDED
+
+#include "../city.h"
+#include "../map.h"
+
+/**
+ * \fn void twoOpt(Map m, City *path)
+ * \brief Fonction qui améliore un chemin par des mouvements 2-opt (listes de voisins, bits "don't look") jusqu'à ce qu'aucun ne soit gagnant.
+ * \param Map m : Map du chemin.
+ * \param City *path : Chemin (mapGetSize(m)+1 villes) modifié sur place, sa ville de départ est gardée.
+ * \return void
+ */
+
+void twoOpt(Map m, City *path);
+
+#endif // TWO_OPT_H_INCLUDED
@@ -120,7 +120,7 @@ void printJSON(Map m, City *path, int algoid)
             fprintf(fp, "\t\t\t\"%d\":{\n\t\t\t\t",i);
             for(int j=0; j<mapGetSize(m); j++)
             {
-                fprintf(fp, "\"%d\" : \"%lf\" ",j,cityGetDist(mapGetCity(m,i),j));
+                fprintf(fp, "\"%d\" : \"%lf\" ",j,mapDist(m, i, j));
                 if(j!=mapGetSize(m)-1)
                     fprintf(fp, ",");
             }
@@ -10,31 +10,29 @@
 #include <stdio.h>
 
 #include "city.h"
+#include "map.h"
 #include "fcts.h"
 
 /** \struct City
- *  \brief Structure City qui est dfini par des distances (et sa position si isPos).
+ *  \brief Structure City qui est dfinie par son indice dans sa Map (et sa position si isPos).
  */
 
 struct _City
 {
     bool isPos; /*!< Boolen qui vaut true si la ville possde des coordonnes cartsiennes. */
     Point pos; /*!< Position de la ville sur la map. */
-    double *dists; /*!< Tableau de distances avec les autres. */
-    int distsSize; /*!< Nombre de distances (c'est--dire nombre de villes - 1). */
+    Map map; /*!< Map  laquelle appartient la ville, c'est elle qui stocke la matrice de distances. */
     int index; /*!< Index de la ville (compris entre 0 et le nombre de villes - 1) */
 };
 
-/** \fn City cityCreate(bool isPos, Point pos, double *distsBuffer, int distsSize)
- *  \brief Cre l'objet de type City par rapport  la matrice de Distance
+/** \fn City cityCreate(bool isPos, Point pos)
+ *  \brief Cre l'objet de type City, ses distances seront lues dans la matrice de la Map qui la recevra
  * \param isPos est  TRUE si City est dfini par un Point
  * \param pos Point qui donne la position de la City
- * \param distsBuffer Tableau de distance
- * \param distsSize nombre de Distances du tableau distsBuffer
  * \return Objet de type City
  */
 
-City cityCreate(bool isPos, Point pos, double *distsBuffer, int distsSize)
+City cityCreate(bool isPos, Point pos)
 {
     throwMsg("City", "Creating city...");
 
@@ -42,12 +40,7 @@ City cityCreate(bool isPos, Point pos, double *distsBuffer, int distsSize)
 
     c->isPos=isPos;
     c->pos=pos;
-    c->dists=malloc(distsSize*sizeof(double));
-
-    for(int i=0; i<distsSize; i++)
-        c->dists[i]=distsBuffer[i];
-
-    c->distsSize=distsSize;
+    c->map=NULL;
     c->index=-1;
 
     return c;
@@ -61,7 +54,6 @@ City cityCreate(bool isPos, Point pos, double *distsBuffer, int distsSize)
 void cityDelete(City c)
 {
     throwMsg("City", "Deleting city...");
-    free(c->dists);
     free(c);
 }
 
@@ -74,9 +66,11 @@ void cityDelete(City c)
 
 double cityGetDist(City c, int i)
 {
-    if(i<0 || i>=c->distsSize)
+    if(!c->map)
+        throwErr("City", "The city isn't in a map (cityGetDist)", NULL);
+    if(i<0 || i>=mapGetSize(c->map))
         throwErr("City", "Distance index out of range (cityGetDist)", NULL);
-    return c->dists[i];
+    return mapDist(c->map, c->index, i);
 }
 
 /** \fn int cityGetDistsSize(City c)
@@ -87,7 +81,9 @@ double cityGetDist(City c, int i)
 
 int cityGetDistsSize(City c)  // retourne le nombre de distances
 {
-    return c->distsSize;
+    if(!c->map)
+        return 0;
+    return mapGetSize(c->map);
 }
 
 /** \fn Point cityGetPos(City c)
@@ -134,6 +130,16 @@ void citySetIndex(City c, int val) {
     c->index=val;
 }
 
+/** \fn void citySetMap(City c, Map m)
+ *  \brief Rattache la ville  la Map qui stocke ses distances
+ * \param c Objet de type City
+ * \param m Map  laquelle appartient la ville
+ */
+
+void citySetMap(City c, Map m) {
+    c->map=m;
+}
+
 /** \fn bool cityEquals(City c1, City c2)
  *  \brief Retourne si deux objets City sont gales
  * \param c1 Objet de type City
@@ -15,16 +15,16 @@
 
 typedef struct _City *City;
 
-/** \fn City cityCreate(bool isPos, Point pos, double *distsBuffer, int distsSize)
- *  \brief Crée l'objet de type City par rapport à la matrice de Distance
+struct _Map;
+
+/** \fn City cityCreate(bool isPos, Point pos)
+ *  \brief Crée l'objet de type City, ses distances seront lues dans la matrice de la Map qui la recevra
  * \param isPos est à TRUE si City est défini par un Point
  * \param pos Point qui donne la position de la City
- * \param distsBuffer Tableau de distance
- * \param distsSize nombre de Distances du tableau distsBuffer
  * \return Objet de type City
  */
 
-City cityCreate(bool, Point pos, double *distsBuffer, int distsSize);
+City cityCreate(bool, Point pos);
 
 /** \fn void cityDelete(City c)
  *  \brief Libère l'objet de type City
@@ -82,6 +82,14 @@ int cityGetIndex(City c);
 
 void citySetIndex(City c, int val);
 
+/** \fn void citySetMap(City c, Map m)
+ *  \brief Rattache la ville à la Map qui stocke ses distances
+ * \param c Objet de type City
+ * \param m Map à laquelle appartient la ville
+ */
+
+void citySetMap(City c, struct _Map *m);
+
 /** \fn bool cityEquals(City c1, City c2)
  *  \brief Retourne si deux objets City sont égales
  * \param c1 Objet de type City
@@ -22,6 +22,10 @@
 #define CLOCKDIV 1
 #elif defined (__linux)
 #define CLOCKDIV 1000
+#include <unistd.h> // sysconf
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h> // mmap
 #endif
 
 
@@ -255,6 +259,162 @@ void freeArrCities(City* arr)
 {
     free(arr);
 }
+/** \fn void *alignedMalloc(size_t size)
+ *
+ * \param size Taille en octets du bloc
+ * \return bloc de size octets aligné sur CACHE_LINE_SIZE, à libérer avec alignedFree
+ *
+ *  Le pointeur renvoyé par malloc est rangé juste avant le bloc aligné pour pouvoir le libérer.
+ */
+
+void *alignedMalloc(size_t size)
+{
+    char *raw=malloc(size+CACHE_LINE_SIZE+sizeof(void*));
+    if(!raw)
+        return NULL;
+
+    size_t addr=(size_t)(raw+sizeof(void*));
+    char *aligned=raw+sizeof(void*)+(CACHE_LINE_SIZE-addr%CACHE_LINE_SIZE)%CACHE_LINE_SIZE;
+    ((void**)aligned)[-1]=raw;
+
+    return aligned;
+}
+/** \fn void alignedFree(void *ptr)
+ *
+ * \param ptr Bloc alloué par alignedMalloc (peut être NULL)
+ *
+ *  Libère un bloc alloué par alignedMalloc
+ */
+
+void alignedFree(void *ptr)
+{
+    if(ptr)
+        free(((void**)ptr)[-1]);
+}
+/** \fn int getNbThreads()
+ *
+ * \return le nombre de threads à lancer pour un calcul parallèle (nombre de processeurs en ligne, au moins 1)
+ *
+ */
+
+int getNbThreads()
+{
+#if defined (__linux) && defined (_SC_NPROCESSORS_ONLN)
+    long nb=sysconf(_SC_NPROCESSORS_ONLN);
+    if(nb>0)
+        return (int)nb;
+#endif
+    return 1;
+}
+/** \fn size_t getAvailableMemory()
+ *
+ * \return la mémoire physique disponible en octets, ou 0 si elle ne peut pas être connue
+ *
+ *  Sous Linux, c'est MemAvailable de /proc/meminfo : la mémoire libre plus le cache qui peut être récupéré. La mémoire
+ *  libre seule (_SC_AVPHYS_PAGES) ne sert que si ce champ manque (noyaux avant 3.14).
+ */
+
+size_t getAvailableMemory()
+{
+#if defined (__linux)
+    FILE *meminfo=fopen("/proc/meminfo", "r");
+
+    if(meminfo)
+    {
+        char line[256];
+        unsigned long kb;
+
+        while(fgets(line, sizeof(line), meminfo))
+            if(sscanf(line, "MemAvailable: %lu kB", &kb)==1)
+            {
+                fclose(meminfo);
+                return (size_t)kb*1024;
+            }
+
+        fclose(meminfo);
+    }
+#endif
+#if defined (__linux) && defined (_SC_AVPHYS_PAGES)
+    long pages=sysconf(_SC_AVPHYS_PAGES);
+    long pageSize=sysconf(_SC_PAGESIZE);
+    if(pages>0 && pageSize>0)
+        return (size_t)pages*(size_t)pageSize;
+#endif
+    return 0;
+}
+/** \fn void *fileMap(Str filename, size_t *size)
+ *
+ * \param filename Chemin du fichier
+ * \param size Taille du fichier en octets (sortie)
+ * \return le contenu du fichier, à libérer avec fileUnmap, ou NULL si le fichier ne peut pas être lu
+ *
+ *  Projette un fichier en mémoire (mmap privé : les pages sont lues à la demande, les écritures ne touchent pas le fichier).
+ *  Sans mmap, le fichier est lu dans un bloc aligné.
+ */
+
+void *fileMap(Str filename, size_t *size)
+{
+#if defined (__linux)
+    int fd=open(filename, O_RDONLY);
+    if(fd<0)
+        return NULL;
+
+    struct stat st;
+    if(fstat(fd, &st)<0 || st.st_size==0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void *addr=mmap(NULL, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // la projection reste valide
+
+    if(addr==MAP_FAILED)
+        return NULL;
+
+    *size=st.st_size;
+    return addr;
+#else
+    FILE *file=fopen(filename, "rb");
+    if(!file)
+        return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long len=ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    void *addr=len>0 ? alignedMalloc(len) : NULL;
+
+    if(addr && fread(addr, 1, len, file)!=(size_t)len)
+    {
+        alignedFree(addr);
+        addr=NULL;
+    }
+
+    fclose(file);
+
+    *size=len;
+    return addr;
+#endif
+}
+/** \fn void fileUnmap(void *addr, size_t size)
+ *
+ * \param addr Contenu renvoyé par fileMap (peut être NULL)
+ * \param size Taille renvoyée par fileMap
+ *
+ *  Libère un fichier projeté par fileMap
+ */
+
+void fileUnmap(void *addr, size_t size)
+{
+    if(!addr)
+        return;
+#if defined (__linux)
+    munmap(addr, size);
+#else
+    alignedFree(addr);
+#endif
+}
 /** \fn Str  getTime()
  *
  * Renvoie la date
@@ -14,9 +14,17 @@
 #define FCTS_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "string.h"
 #include "city.h"
 
+/**
+* \def CACHE_LINE_SIZE
+* \brief Taille d'une ligne de cache, utilisée pour aligner les gros tableaux (matrice de distances).
+*/
+
+#define CACHE_LINE_SIZE 64
+
 /** \fn void setVerboseMode(int v)
  *
  * \param v Le niveau de verbose
@@ -140,6 +148,54 @@ City* arrCitiesCreate(int nb);
  *
  */
 void freeArrCities(City* arr);
+/** \fn void *alignedMalloc(size_t size)
+ *
+ * \param size Taille en octets du bloc
+ * \return bloc de size octets aligné sur CACHE_LINE_SIZE, à libérer avec alignedFree
+ *
+ *  Alloue un bloc mémoire aligné sur une ligne de cache
+ *
+ */
+void *alignedMalloc(size_t size);
+/** \fn void alignedFree(void *ptr)
+ *
+ * \param ptr Bloc alloué par alignedMalloc (peut être NULL)
+ *
+ *  Libère un bloc alloué par alignedMalloc
+ *
+ */
+void alignedFree(void *ptr);
+/** \fn int getNbThreads()
+ *
+ * \return le nombre de threads à lancer pour un calcul parallèle (nombre de processeurs en ligne, au moins 1)
+ *
+ */
+int getNbThreads();
+/** \fn size_t getAvailableMemory()
+ *
+ * \return la mémoire physique disponible en octets (cache récupérable compris), ou 0 si elle ne peut pas être connue
+ *
+ */
+size_t getAvailableMemory();
+/** \fn void *fileMap(Str filename, size_t *size)
+ *
+ * \param filename Chemin du fichier
+ * \param size Taille du fichier en octets (sortie)
+ * \return le contenu du fichier, à libérer avec fileUnmap, ou NULL si le fichier ne peut pas être lu
+ *
+ *  Projette un fichier en mémoire (mmap privé)
+ *
+ */
+void *fileMap(Str filename, size_t *size);
+/** \fn void fileUnmap(void *addr, size_t size)
+ *
+ * \param addr Contenu renvoyé par fileMap (peut être NULL)
+ * \param size Taille renvoyée par fileMap
+ *
+ *  Libère un fichier projeté par fileMap
+ *
+ */
+void fileUnmap(void *addr, size_t size);
 /** \fn Str  getTime()
  *
  * Renvoie la date
@@ -11,6 +11,7 @@
 #include <stdbool.h>
 
 #include "tsp.h"
+#include "tspbin.h"
 #include "string.h"
 #include "city.h"
 #include "point.h"
@@ -18,6 +19,7 @@
 #include "fcts.h"
 #include "gui/gui.h"
 #include "algos/algos.h"
+#include "algos/lin_kernighan.h"
 #include "api.h"
 
 /**
@@ -73,11 +75,24 @@ void phelp(Str name)
     printf("-bb : Execute l'algorithme exact avec branch and bound\n");
     printf("-bbr : Execute l'algorithme exact avec branch and bound et relaxation NN+MST\n");
     printf("-bbrhk : Execute l'algorithme exact avec branch and bound et la relaxation de Held Karp\n");
+    printf("-hk : Execute l'algorithme exact de Held et Karp par programmation dynamique (jusqu'a environ 25 villes, 5 n 2^n octets de memoire)\n");
     printf("-bf : Execute l'algorithme exact avec recherche exhaustive (Iteratif)\n");
     printf("-bfrec : Execute l'algorithme exact avec recherche exhaustive (Recursive - plus lente)\n");
     printf("-bfmt : Execute l'algorithme exact avec recherche exhaustive Multithreadee \n");
     printf("-mst : Execute l'algorithme minimum spanning tree\n");
     printf("-nn : Execute l'algorithme du plus proche voisin\n");
+    printf("-nnms : Execute l'algorithme du plus proche voisin depuis toutes les villes (en parallele) et garde le meilleur chemin\n");
+    printf("-cw : Execute l'algorithme des economies de Clarke et Wright, depuis la ville de depart (depot)\n");
+    printf("-ge : Execute l'algorithme glouton sur les aretes (multi-fragment) : les plus courtes aretes vers les plus proches voisins sont gardees\n");
+    printf("-hil : Execute l'algorithme de la courbe de Hilbert (villes avec coordonnees, tres rapide pour des millions de villes)\n");
+    printf("-ni : Execute l'algorithme d'insertion de la ville la plus proche du chemin\n");
+    printf("-fi : Execute l'algorithme d'insertion de la ville la plus eloignee du chemin\n");
+    printf("-ci : Execute l'algorithme d'insertion de la ville qui allonge le moins le chemin\n");
+    printf("-chi : Execute l'algorithme d'insertion depuis l'enveloppe convexe des villes\n");
+    printf("-chr : Execute l'algorithme de Christofides (arbre couvrant minimum et couplage parfait, au plus 1.5 fois l'optimal)\n");
+    printf("-lk : Execute l'algorithme de Lin-Kernighan itere (mouvements k-opt sequentiels et perturbations, voir -lkt)\n");
+    printf("-2opt : Ameliore le chemin de chaque algorithme par des mouvements 2-opt\n");
+    printf("-oropt : Ameliore le chemin de chaque algorithme en deplacant des trajets de 1 a 3 villes (apres -2opt si les deux sont demandes)\n");
 
     printf("\n\tOptions d'affichage:\n");
     printf("-g : Mode graphique, seules les options -v, -w, -we comptent\n");
@@ -90,10 +105,15 @@ void phelp(Str name)
     printf("\n\tOptions de traitement:\n");
     printf("-le : Definir le mode de calcul de distances en euclidiennes (defaut)\n");
     printf("-lm : Definir le mode de calcul de distances en manhattan\n");
+    printf("-lazy : Ne garde que les coordonnees des villes et calcule les distances a la demande (automatique pour les tres grandes cartes)\n");
+    printf("-knn : Calcule les listes des k plus proches voisins de chaque ville. Utiliser -knn <k>\n");
+    printf("-lkt : Duree des perturbations de -lk en secondes. Utiliser -lkt <secondes> (defaut 1, 0 pour s'arreter au premier optimum local)\n");
+    printf("-prec : Precision de stockage des distances. Utiliser -prec <double|float|int|q16> (defaut double, int arrondit comme TSPLIB, q16 quantifie sur 16 bits)\n");
 
     printf("-api : Retourne un fichier au format JSON avec les resultats d'un algorithme\n");
     printf("-o : Genere le fichier TSP correspondant au calcul aleatoire (-r)\n");
     printf("-r : Ajoute une carte de villes aleatoires. Utliser -r <nbCities> [startCity] ou nbCities est le nombre de villes a creer et startCity est la ville de depart\n");
+    printf("-wb : Genere le cache binaire de la carte (fichier TSP ou -r) au lieu d'executer les algorithmes, il se relit comme un fichier TSP sans calcul. Utiliser -wb <file>\n");
     printf("-to : Genere le fichier TSP TOUR correspondant au meilleur resultat parmi les algorithmes executes\n");
 }
 
@@ -148,6 +168,11 @@ int main(int argc, Str *argv)
 
     bool tour=false;
 
+    bool binOutput=false;
+    Str binName;
+
+    int knn=0;
+
     welcome();
 
     if(argc>1)
@@ -202,6 +227,32 @@ int main(int argc, Str *argv)
                 algos[6]=true;
             else if(strCmp(argv[i], "-bbrhk"))
                 algos[7]=true;
+            else if(strCmp(argv[i], "-hk"))
+                algos[18]=true;
+            else if(strCmp(argv[i], "-nnms"))
+                algos[8]=true;
+            else if(strCmp(argv[i], "-chr"))
+                algos[9]=true;
+            else if(strCmp(argv[i], "-cw"))
+                algos[12]=true;
+            else if(strCmp(argv[i], "-ge"))
+                algos[11]=true;
+            else if(strCmp(argv[i], "-hil"))
+                algos[13]=true;
+            else if(strCmp(argv[i], "-ni"))
+                algos[14]=true;
+            else if(strCmp(argv[i], "-fi"))
+                algos[15]=true;
+            else if(strCmp(argv[i], "-ci"))
+                algos[16]=true;
+            else if(strCmp(argv[i], "-chi"))
+                algos[17]=true;
+            else if(strCmp(argv[i], "-lk"))
+                algos[10]=true;
+            else if(strCmp(argv[i], "-2opt"))
+                setImprove(0, true);
+            else if(strCmp(argv[i], "-oropt"))
+                setImprove(1, true);
             else if(strCmp(argv[i], "-all"))
                 for(int i=0; i<NB_ALGOS; i++)
                     algos[i]=true;
@@ -261,6 +312,63 @@ int main(int argc, Str *argv)
 
                 outName=argv[i];
             }
+            else if(strCmp(argv[i], "-wb"))
+            {
+                binOutput=true;
+
+                i++;
+
+                if(i>=argc)
+                    throwErr("Main", "Expecting a name for binary output", NULL);
+
+                binName=argv[i];
+            }
+            else if(strCmp(argv[i], "-knn"))
+            {
+                i++;
+
+                if(i>=argc)
+                    throwErr("Main", "Expecting -knn <k>", NULL);
+
+                for(int j=0; argv[i][j]!='\0'; j++)
+                    if(!isNumber(argv[i][j]))
+                        throwErr("Main", "Expecting -knn <k>", NULL);
+
+                knn=atoi(argv[i]);
+            }
+            else if(strCmp(argv[i], "-lkt"))
+            {
+                i++;
+
+                if(i>=argc)
+                    throwErr("Main", "Expecting -lkt <seconds>", NULL);
+
+                for(int j=0; argv[i][j]!='\0'; j++)
+                    if(!isNumber(argv[i][j]) && argv[i][j]!='.')
+                        throwErr("Main", "Expecting -lkt <seconds>", NULL);
+
+                setLkTimeLimit(atof(argv[i]));
+            }
+            else if(strCmp(argv[i], "-lazy"))
+                setDistsLazy(true);
+            else if(strCmp(argv[i], "-prec"))
+            {
+                i++;
+
+                if(i>=argc)
+                    throwErr("Main", "Expecting -prec <double|float|int|q16>", NULL);
+
+                if(strCmp(argv[i], "double"))
+                    setDistsType(DISTS_DOUBLE);
+                else if(strCmp(argv[i], "float"))
+                    setDistsType(DISTS_FLOAT);
+                else if(strCmp(argv[i], "int"))
+                    setDistsType(DISTS_INT);
+                else if(strCmp(argv[i], "q16"))
+                    setDistsType(DISTS_Q16);
+                else
+                    throwErr("Main", "Expecting -prec <double|float|int|q16>", NULL);
+            }
             else if(strCmp(argv[i], "-h"))
                 help=true;
             else if(strCmp(argv[i], "-to"))
@@ -320,7 +428,12 @@ int main(int argc, Str *argv)
     {
         Map m = mapCreateRandom(randNb);
 
-        if(!output)
+        if(knn>0)
+            mapBuildNeighbours(m, knn);
+
+        if(binOutput)
+            tspBinWrite(m, binName);
+        else if(!output)
         {
             if(getVerboseMode()>=2)
                 mapDataDump(m);
@@ -378,7 +491,12 @@ int main(int argc, Str *argv)
                 throwErr("Main", erroMsg, argv[files[i]]);
             }
 
-            if(! api)
+            if(knn>0)
+                mapBuildNeighbours(m, knn);
+
+            if(binOutput)
+                tspBinWrite(m, binName);
+            else if(! api)
             {
                 executeAlgos(m, algos, start[i], graphics, tour); //, test);
 
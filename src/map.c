@@ -10,30 +10,87 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
 
 #include "map.h"
 #include "city.h"
 #include "fcts.h"
 #include "algos/algos.h"
+#include "algos/kdtree.h"
 
 #define CITIESINIT 10
 
-/** \struct _Map
- *  \brief Structure représentant une Map contenant les villes.
+/**
+* \def Q16_MAX
+* \brief Plus grande valeur stockable dans une distance quantifiée sur 16 bits.
+*/
+
+#define Q16_MAX 65535
+
+/**
+* \def LAZY_DISTS_BYTES
+* \brief Taille de matrice (en octets) au-delà de laquelle une Map de points calcule ses distances à la demande.
+*/
+
+#define LAZY_DISTS_BYTES ((size_t)1<<30)
+
+/**
+* \def FILL_MT_MIN_CITIES
+* \brief Nombre de villes à partir duquel la matrice est calculée par plusieurs threads.
+*/
+
+#define FILL_MT_MIN_CITIES 1000
+
+/** \struct fill_params
+ *  \brief Paramètres d'un thread de calcul de la matrice : il traite les lignes first, first+step, first+2*step...
  */
 
-struct _Map
+struct fill_params
 {
-    bool isPos; /*!< Booléen qui vaut true lorsque la map est generée par des City déterminées par des points (et non une matrice de distance seulement). */
-    City* cities; /*!< Tableau de villes extensible. */
-    int nbCities; /*!< Nombre de villes dans le tableau. */
-    int nbCitiesMax; /*!< Nombre de villes maximum. */
-    Str name; /*!< Nom du fichier TSP associé à la Map. */
-    City **paths; /*!< Tableau à deux dimensions contenant les chemins de obtenus par chaque algorithme. */
-    double *duration; /*!< Tableau stockant les temps d'exécution de chaque algorithme. */
-    int startCity; /*!< L'index de la ville de départ de la Map. */
+    Map m; /*!< Map dont la matrice est remplie. */
+    const double *xs; /*!< Abscisses des points, rangées à part pour la vectorisation. */
+    const double *ys; /*!< Ordonnées des points. */
+    int first; /*!< Première ligne traitée par le thread. */
+    int step; /*!< Écart entre deux lignes traitées (nombre de threads). */
 };
 
+/** \struct neighbours_params
+ *  \brief Paramètres d'un thread de calcul des listes de voisins : il traite les villes first, first+step, first+2*step...
+ */
+
+struct neighbours_params
+{
+    Map m; /*!< Map dont les listes sont calculées. */
+    KdTree tree; /*!< Arbre k-d des villes (NULL pour parcourir les lignes de distances). */
+    int first; /*!< Première ville traitée par le thread. */
+    int step; /*!< Écart entre deux villes traitées (nombre de threads). */
+};
+
+int distsType=DISTS_DOUBLE;
+bool distsLazy=false;
+
+
+
+/** \fn void setDistsType(int val)
+ *  \brief Met la précision de stockage des distances pour les Map créées ensuite
+ *  \param val DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+void setDistsType(int val)
+{
+    distsType=val;
+}
+
+/** \fn void setDistsLazy(bool val)
+ *  \brief Force le calcul des distances à la demande pour les Map de points créées ensuite
+ *  \param val true pour ne garder que les coordonnées, false pour laisser la taille de la Map décider
+ */
+
+void setDistsLazy(bool val)
+{
+    distsLazy=val;
+}
 
 /** \fn Map mapCreate()
  *  \brief mapCreate crée une instance de Map (avec allocation mémoire)
@@ -50,14 +107,33 @@ Map mapCreate()
     mapTMP->nbCities=0;
     mapTMP->nbCitiesMax=CITIESINIT;
     mapTMP->cities=malloc(sizeof(City)*mapTMP->nbCitiesMax);
+    mapTMP->dists=NULL;
+    mapTMP->xs=NULL;
+    mapTMP->ys=NULL;
+    mapSetLengthType(mapTMP, getLengthType());
+    mapTMP->distsSize=0;
+    mapTMP->distsLayout=DISTS_FULL;
+    mapTMP->distsType=distsType;
+    mapTMP->distsScale=1;
+    mapTMP->distsClamped=false;
     mapTMP->name=NULL;
     mapTMP->paths=malloc(NB_ALGOS*sizeof(City*));
     mapTMP->startCity=0;
+    mapTMP->neighbours=NULL;
+    mapTMP->nbNeighbours=0;
+    mapTMP->mapping=NULL;
+    mapTMP->mappingSize=0;
+
+    mapTMP->improvedPaths=malloc(NB_ALGOS*sizeof(City*));
 
     for(int i=0; i<NB_ALGOS; i++)
+    {
         mapTMP->paths[i]=NULL;
+        mapTMP->improvedPaths[i]=NULL;
+    }
 
     mapTMP->duration=malloc(NB_ALGOS*sizeof(double));
+    mapTMP->improvedDuration=malloc(NB_ALGOS*sizeof(double));
 
     return mapTMP;
 }
@@ -138,6 +214,54 @@ void mapSetDuration(Map m, int i, double val)
     m->duration[i]=val;
 }
 
+/** \fn City *mapGetImprovedPath(Map m, int i)
+ * \brief Retourne le chemin de l'algorithme i après les heuristiques d'amélioration
+ * \param m Map contenant le chemin
+ * \param i Entier passé en index désignant l'algorithme
+ * \return tableau de City, NULL si aucune amélioration n'a été appliquée
+ */
+
+City *mapGetImprovedPath(Map m, int i)
+{
+    return m->improvedPaths[i];
+}
+
+/** \fn void mapSetImprovedPath(Map m, int i, City *path)
+ * \brief Modifie le chemin amélioré de l'algorithme i (le chemin de l'algorithme, mapGetPath, n'est pas modifié)
+ * \param m Map contenant le chemin
+ * \param i Entier passé en index désignant l'algorithme
+ * \param path tableau de City représentant le chemin amélioré
+ */
+
+void mapSetImprovedPath(Map m, int i, City *path)
+{
+    m->improvedPaths[i]=path;
+}
+
+/** \fn double mapGetImprovedDuration(Map m, int i)
+ * \brief Retourne le temps d'exécution de l'algorithme i, améliorations comprises
+ * \param m Map stockant le tableau improvedDuration
+ * \param i Entier passé en index désignant l'algorithme
+ * \return nombre de type double (précision)
+ */
+
+double mapGetImprovedDuration(Map m, int i)
+{
+    return m->improvedDuration[i];
+}
+
+/** \fn void mapSetImprovedDuration(Map m, int i, double val)
+ * \brief Modifie le tableau improvedDuration
+ * \param m Map stockant le tableau improvedDuration
+ * \param i Entier passé en index désignant l'algorithme
+ * \param val temps d'exécution de l'algorithme et des améliorations
+ */
+
+void mapSetImprovedDuration(Map m, int i, double val)
+{
+    m->improvedDuration[i]=val;
+}
+
 
 /** \fn double mapGetStartCity(Map m)
  * \brief Retourne la ville de départ de la Map
@@ -162,6 +286,18 @@ void mapSetStartCity(Map m, int val)
     m->startCity=val;
 }
 
+/** \fn static bool mapIsMapped(Map m, const void *p)
+ *  \brief Indique si un bloc de la Map est dans son fichier projeté (il ne doit alors pas être libéré)
+ * \param m Objet de type Map
+ * \param p Bloc de la Map
+ * \return true si p pointe dans le fichier projeté
+ */
+
+static bool mapIsMapped(Map m, const void *p)
+{
+    return m->mapping && (const char*)p>=(const char*)m->mapping && (const char*)p<(const char*)m->mapping+m->mappingSize;
+}
+
 /** \fn void mapDelete(Map m)
  *  \brief Supprime et libère la mémoire utilisée par la Map passée en paramètre
  * \param m Map qu'il faut libérer
@@ -177,15 +313,36 @@ void mapDelete(Map m)
 
     free(m->paths);
 
+    for(int i=0; i<NB_ALGOS; i++)
+        if(m->improvedPaths[i])
+            free(m->improvedPaths[i]);
+
+    free(m->improvedPaths);
+
     free(m->duration);
+    free(m->improvedDuration);
 
     free(m->cities);
 
+    if(!mapIsMapped(m, m->dists))
+        alignedFree(m->dists);
+
+    if(!mapIsMapped(m, m->xs))
+    {
+        free(m->xs);
+        free(m->ys);
+    }
+
+    if(!mapIsMapped(m, m->neighbours))
+        free(m->neighbours);
+
+    fileUnmap(m->mapping, m->mappingSize);
+
     if(m->name)
         free(m->name);
 
     free(m);
-}
+}
 
 /** \fn mapDeleteRec(Map m)
  *  \brief supprime les instances de type City de l'objet Map passé en paramètre
@@ -215,23 +372,507 @@ void mapAddCity(Map m, City c)
         m->cities=realloc(m->cities, sizeof(City)*m->nbCitiesMax);
     }
 
+    if(m->nbCities>=m->distsSize)
+        throwErr("Map", "No distances available for this city (mapAddCity)", NULL);
+
     if(!cityGetIsPos(c))
         m->isPos=false;
 
     citySetIndex(c, m->nbCities);
+    citySetMap(c, m);
 
     m->cities[m->nbCities++]=c;
 }
 
 
-/** \fn City mapGetCity(Map m, int indice)
- *  \brief Retourne l'objet City par son indice indice dans la Map m
+/** \fn static size_t distsCount(int nbVilles, int layout)
+ *  \brief Retourne le nombre de distances à stocker pour une matrice de nbVilles villes
+ * \param nbVilles Nombre de villes
+ * \param layout DISTS_FULL ou DISTS_TRIANGLE
+ * \return Nombre de cases de la matrice
+ */
+
+static size_t distsCount(int nbVilles, int layout)
+{
+    if(layout==DISTS_TRIANGLE)
+        return (size_t)nbVilles*(nbVilles+1)/2;
+    return (size_t)nbVilles*nbVilles;
+}
+
+/** \fn static size_t distsElemSize(int type)
+ *  \brief Retourne la taille en octets d'une distance stockée avec la précision type
+ * \param type DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ * \return Taille d'une case de la matrice
+ */
+
+static size_t distsElemSize(int type)
+{
+    switch(type)
+    {
+    case DISTS_FLOAT:
+        return sizeof(float);
+    case DISTS_INT:
+        return sizeof(int32_t);
+    case DISTS_Q16:
+        return sizeof(uint16_t);
+    default:
+        return sizeof(double);
+    }
+}
+
+/** \fn void mapAllocDists(Map m, int nbVilles, int layout)
+ *  \brief Alloue la matrice de distances de la Map d'un seul bloc
+ * \param m Objet de type Map (sans matrice de distances)
+ * \param nbVilles Nombre de villes que contiendra la Map
+ * \param layout DISTS_FULL pour une matrice complète, DISTS_TRIANGLE pour une matrice symétrique (moitié de la mémoire)
+ */
+
+void mapAllocDists(Map m, int nbVilles, int layout)
+{
+    if(m->dists || m->xs)
+        throwErr("Map", "Distances already allocated (mapAllocDists)", NULL);
+
+    m->dists=alignedMalloc(distsCount(nbVilles, layout)*distsElemSize(m->distsType));
+
+    if(!m->dists && nbVilles>0)
+        throwErr("Map", "Not enough memory for the distance matrix (mapAllocDists)", NULL);
+
+    m->distsSize=nbVilles;
+    m->distsLayout=layout;
+}
+
+/** \fn void mapUnpackDists(Map m)
+ *  \brief Passe la matrice d'une Map du stockage triangle au stockage complet (matrice finalement non symétrique)
+ * \param m Objet de type Map
+ */
+
+void mapUnpackDists(Map m)
+{
+    if(m->distsLayout==DISTS_FULL)
+        return;
+
+    if(m->distsLayout==DISTS_LAZY)
+        throwErr("Map", "No distance matrix to unpack (mapUnpackDists)", NULL);
+
+    throwMsg("Map", "Unpacking distances...");
+
+    int n=m->distsSize;
+    size_t elemSize=distsElemSize(m->distsType);
+    char *full=alignedMalloc(distsCount(n, DISTS_FULL)*elemSize);
+
+    if(!full && n>0)
+        throwErr("Map", "Not enough memory for the distance matrix (mapUnpackDists)", NULL);
+
+    for(int i=0; i<n; i++)
+        for(int j=0; j<n; j++)
+            memcpy(full+((size_t)i*n+j)*elemSize, (char*)m->dists+mapDistIndex(m, i, j)*elemSize, elemSize);
+
+    if(!mapIsMapped(m, m->dists))
+        alignedFree(m->dists);
+    m->dists=full;
+    m->distsLayout=DISTS_FULL;
+}
+
+/** \fn void mapAttachMapping(Map m, void *addr, size_t size)
+ *  \brief Confie à la Map un fichier projeté en mémoire (voir fileMap) : les blocs qui y pointent ne sont pas libérés, le fichier est libéré par mapDelete
+ * \param m Objet de type Map
+ * \param addr Contenu du fichier
+ * \param size Taille du fichier
+ */
+
+void mapAttachMapping(Map m, void *addr, size_t size)
+{
+    if(m->mapping)
+        throwErr("Map", "A file is already mapped (mapAttachMapping)", NULL);
+
+    m->mapping=addr;
+    m->mappingSize=size;
+}
+
+/** \fn void mapUseDists(Map m, void *dists, int nbVilles, int layout, double scale)
+ *  \brief Donne à la Map une matrice de distances déjà remplie (par exemple dans un fichier projeté) au lieu de l'allouer
+ * \param m Objet de type Map (sans matrice de distances, précision déjà choisie)
+ * \param dists Bloc de distances au format de mapGetDistsData
+ * \param nbVilles Nombre de villes que contiendra la Map
+ * \param layout DISTS_FULL ou DISTS_TRIANGLE
+ * \param scale Pas de quantification (DISTS_Q16)
+ */
+
+void mapUseDists(Map m, void *dists, int nbVilles, int layout, double scale)
+{
+    if(m->dists || m->xs)
+        throwErr("Map", "Distances already allocated (mapUseDists)", NULL);
+
+    m->dists=dists;
+    m->distsSize=nbVilles;
+    m->distsLayout=layout;
+    m->distsScale=scale;
+}
+
+/** \fn void mapUseCoords(Map m, double *xs, double *ys, int nbVilles)
+ *  \brief Passe la Map en mode DISTS_LAZY avec des coordonnées déjà rangées par axe (par exemple dans un fichier projeté)
+ * \param m Objet de type Map (sans matrice de distances)
+ * \param xs Abscisses des nbVilles villes
+ * \param ys Ordonnées des nbVilles villes
+ * \param nbVilles Nombre de villes que contiendra la Map
+ */
+
+void mapUseCoords(Map m, double *xs, double *ys, int nbVilles)
+{
+    if(m->dists || m->xs)
+        throwErr("Map", "Distances already allocated (mapUseCoords)", NULL);
+
+    m->xs=xs;
+    m->ys=ys;
+    m->distsSize=nbVilles;
+    m->distsLayout=DISTS_LAZY;
+}
+
+/** \fn const void *mapGetDistsData(Map m, size_t *bytes)
+ *  \brief Retourne le bloc de la matrice de distances tel qu'il est stocké (voir mapGetDistsLayout et mapGetDistsType)
+ * \param m Objet de type Map
+ * \param bytes Taille du bloc en octets (sortie, 0 en mode DISTS_LAZY)
+ * \return Le bloc de distances, NULL en mode DISTS_LAZY
+ */
+
+const void *mapGetDistsData(Map m, size_t *bytes)
+{
+    if(m->distsLayout==DISTS_LAZY)
+    {
+        *bytes=0;
+        return NULL;
+    }
+
+    *bytes=distsCount(m->distsSize, m->distsLayout)*distsElemSize(m->distsType);
+    return m->dists;
+}
+
+/** \fn double mapGetDistsScale(Map m)
+ *  \brief Retourne le pas de quantification des distances DISTS_Q16
+ * \param m Objet de type Map
+ * \return Pas de quantification
+ */
+
+double mapGetDistsScale(Map m)
+{
+    return m->distsScale;
+}
+
+/** \fn const double *mapGetXs(Map m)
+ *  \brief Retourne les abscisses des villes d'une Map DISTS_LAZY, rangées par axe pour les calculs ligne par ligne
+ * \param m Objet de type Map
+ * \return Tableau de mapGetSize(m) abscisses, NULL si la Map a une matrice de distances
+ */
+
+const double *mapGetXs(Map m)
+{
+    return m->xs;
+}
+
+/** \fn const double *mapGetYs(Map m)
+ *  \brief Retourne les ordonnées des villes d'une Map DISTS_LAZY
+ * \param m Objet de type Map
+ * \return Tableau de mapGetSize(m) ordonnées, NULL si la Map a une matrice de distances
+ */
+
+const double *mapGetYs(Map m)
+{
+    return m->ys;
+}
+
+/** \fn int mapGetDistsLayout(Map m)
+ *  \brief Retourne le mode de stockage de la matrice de distances
+ * \param m Objet de type Map
+ * \return DISTS_FULL, DISTS_TRIANGLE ou DISTS_LAZY
+ */
+
+int mapGetDistsLayout(Map m)
+{
+    return m->distsLayout;
+}
+
+/** \fn bool mapIsSymmetric(Map m)
+ *  \brief Indique si les distances de la Map sont symétriques (d(i, j) == d(j, i) pour toutes les villes)
+ * \param m Objet de type Map
+ * \return true sauf pour une matrice DISTS_FULL non symétrique (instance ATSP)
+ */
+
+bool mapIsSymmetric(Map m)
+{
+    if(m->distsLayout!=DISTS_FULL)
+        return true;
+
+    for(int i=0; i<m->distsSize; i++)
+        for(int j=0; j<i; j++)
+            if(mapDist(m, i, j)!=mapDist(m, j, i))
+                return false;
+
+    return true;
+}
+
+/** \fn double mapDistChecked(Map m, int i, int j)
+ *  \brief Version vérifiée de mapDist (build de debug, TSP_CHECKS) : contrôle les indices avant la lecture
+ * \param m Objet de type Map
+ * \param i Indice de la première ville
+ * \param j Indice de la deuxième ville
+ * \return Distance entre les deux villes
+ */
+
+double mapDistChecked(Map m, int i, int j)
+{
+    if(i<0 || i>=m->distsSize || j<0 || j>=m->distsSize)
+        throwErr("Map", "Distance index out of range (mapDist)", NULL);
+
+    return mapDistUnchecked(m, i, j);
+}
+
+/** \fn static void distStore(Map m, size_t k, double val)
+ *  \brief Range une distance à la position k de la matrice, convertie dans la précision de la Map
+ * \param m Objet de type Map
+ * \param k Position dans la matrice (voir distIndex)
+ * \param val Distance à stocker
+ */
+
+static void distStore(Map m, size_t k, double val)
+{
+    switch(m->distsType)
+    {
+    case DISTS_FLOAT:
+        ((float*)m->dists)[k]=(float)val;
+        break;
+    case DISTS_INT:
+        ((int32_t*)m->dists)[k]=(int32_t)floor(val+0.5);
+        break;
+    case DISTS_Q16:
+    {
+        double q=floor(val/m->distsScale+0.5);
+        if(q>Q16_MAX)
+        {
+            if(!m->distsClamped)
+                throwWarn("Map", "Distance too large for 16 bits storage, clamped", NULL);
+            m->distsClamped=true;
+            q=Q16_MAX;
+        }
+        ((uint16_t*)m->dists)[k]=(uint16_t)q;
+        break;
+    }
+    default:
+        ((double*)m->dists)[k]=val;
+    }
+}
+
+/** \fn static void distStoreRow(Map m, size_t k, const double *vals, int nb)
+ *  \brief Range nb distances consécutives à partir de la position k, converties dans la précision de la Map
+ * \param m Objet de type Map
+ * \param k Position de la première distance dans la matrice
+ * \param vals Distances à stocker
+ * \param nb Nombre de distances
+ */
+
+static void distStoreRow(Map m, size_t k, const double *vals, int nb)
+{
+    switch(m->distsType)
+    {
+    case DISTS_FLOAT:
+    {
+        float *row=(float*)m->dists+k;
+        for(int j=0; j<nb; j++)
+            row[j]=(float)vals[j];
+        break;
+    }
+    case DISTS_INT:
+    {
+        int32_t *row=(int32_t*)m->dists+k;
+        for(int j=0; j<nb; j++)
+            row[j]=(int32_t)floor(vals[j]+0.5);
+        break;
+    }
+    default:
+        for(int j=0; j<nb; j++)
+            distStore(m, k+j, vals[j]);
+    }
+}
+
+/** \fn static double distLoad(const void *dists, int type, double scale, size_t k)
+ *  \brief Retourne la distance rangée à la position k d'un bloc de distances de précision type
+ * \param dists Bloc de distances
+ * \param type DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ * \param scale Pas de quantification (DISTS_Q16)
+ * \param k Position dans le bloc
+ * \return Distance
+ */
+
+static double distLoad(const void *dists, int type, double scale, size_t k)
+{
+    switch(type)
+    {
+    case DISTS_FLOAT:
+        return ((const float*)dists)[k];
+    case DISTS_INT:
+        return ((const int32_t*)dists)[k];
+    case DISTS_Q16:
+        return ((const uint16_t*)dists)[k]*scale;
+    default:
+        return ((const double*)dists)[k];
+    }
+}
+
+/** \fn void mapConvertDists(Map m, int type)
+ *  \brief Change la précision de stockage d'une matrice déjà remplie ; en DISTS_Q16, le pas est choisi d'après la plus grande distance
+ * \param m Objet de type Map (matrice DISTS_FULL ou DISTS_TRIANGLE)
+ * \param type DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+void mapConvertDists(Map m, int type)
+{
+    if(m->distsType==type)
+        return;
+
+    if(m->distsLayout==DISTS_LAZY)
+        throwErr("Map", "No distance matrix to convert (mapConvertDists)", NULL);
+
+    throwMsg("Map", "Converting distances...");
+
+    size_t count=distsCount(m->distsSize, m->distsLayout);
+    void *old=m->dists;
+    int oldType=m->distsType;
+    double oldScale=m->distsScale;
+    char *conv=alignedMalloc(count*distsElemSize(type));
+
+    if(!conv && count>0)
+        throwErr("Map", "Not enough memory for the distance matrix (mapConvertDists)", NULL);
+
+    if(type==DISTS_Q16)
+    {
+        double maxDist=0;
+
+        for(size_t k=0; k<count; k++)
+            maxDist=fmax(maxDist, distLoad(old, oldType, oldScale, k));
+
+        mapSetDistsScale(m, maxDist);
+    }
+
+    m->dists=conv;
+    m->distsType=type;
+
+    for(size_t k=0; k<count; k++)
+        distStore(m, k, distLoad(old, oldType, oldScale, k));
+
+    if(!mapIsMapped(m, old))
+        alignedFree(old);
+}
+
+/** \fn int mapGetDistsType(Map m)
+ *  \brief Retourne la précision de stockage de la matrice de distances
+ * \param m Objet de type Map
+ * \return DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+int mapGetDistsType(Map m)
+{
+    return m->distsType;
+}
+
+/** \fn void mapSetDistsType(Map m, int type)
+ *  \brief Choisit la précision de stockage de la matrice de distances de la Map (à la place du réglage global)
+ * \param m Objet de type Map (avant l'allocation de la matrice)
+ * \param type DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+void mapSetDistsType(Map m, int type)
+{
+    if(m->dists)
+        throwErr("Map", "Distances already allocated (mapSetDistsType)", NULL);
+
+    m->distsType=type;
+}
+
+/** \fn void mapSetDistsScale(Map m, double maxDist)
+ *  \brief Choisit le pas de quantification DISTS_Q16 pour que maxDist soit la plus grande distance représentable
+ * \param m Objet de type Map (avant le remplissage de la matrice)
+ * \param maxDist Borne supérieure des distances de la Map
+ */
+
+void mapSetDistsScale(Map m, double maxDist)
+{
+    if(maxDist>0)
+        m->distsScale=maxDist/Q16_MAX;
+}
+
+/** \fn void mapSetLengthType(Map m, int type)
+ *  \brief Choisit la distance entre les points de la Map et ses noyaux de calcul (une fois pour toute la Map)
+ * \param m Objet de type Map (avant le chargement des points)
+ * \param type EUCLIDIAN, MANHATTAN ou une distance TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D)
+ */
+
+void mapSetLengthType(Map m, int type)
+{
+    m->lengthType=type;
+    m->lengthFct=lengthGetFct(type);
+    m->lengthRowFct=lengthGetRowFct(type);
+}
+
+/** \fn int mapGetLengthType(Map m)
+ *  \brief Retourne la distance utilisée entre les points de la Map
+ * \param m Objet de type Map
+ * \return EUCLIDIAN, MANHATTAN ou une distance TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D), voir point.h
+ */
+
+int mapGetLengthType(Map m)
+{
+    return m->lengthType;
+}
+
+/** \fn void mapDistsFrom(Map m, int i, double *out)
+ *  \brief Remplit out avec les distances de la ville i à toutes les villes de la Map
+ * \param m Objet de type Map
+ * \param i Indice de la ville
+ * \param out Tableau de mapGetSize(m) distances
+ *
+ * En mode DISTS_LAZY la ligne est calculée d'un coup par le noyau de la Map, sinon elle est lue dans la matrice.
+ */
+
+void mapDistsFrom(Map m, int i, double *out)
+{
+    int n=m->distsSize;
+
+    if(m->distsLayout==DISTS_LAZY)
+    {
+        Point p={m->xs[i], m->ys[i]};
+        m->lengthRowFct(p, m->xs, m->ys, out, n);
+    }
+    else
+        for(int j=0; j<n; j++)
+            out[j]=mapDistUnchecked(m, i, j);
+}
+
+/** \fn void mapSetDist(Map m, int i, int j, double val)
+ *  \brief Ecrit la distance entre les villes d'indices i et j dans la matrice
+ * \param m Objet de type Map
+ * \param i Indice de la première ville
+ * \param j Indice de la deuxième ville
+ * \param val Distance entre les deux villes
+ */
+
+void mapSetDist(Map m, int i, int j, double val)
+{
+    if(i<0 || i>=m->distsSize || j<0 || j>=m->distsSize)
+        throwErr("Map", "Distance index out of range (mapSetDist)", NULL);
+
+    if(m->distsLayout==DISTS_LAZY)
+        throwErr("Map", "Distances of this map are computed from its points (mapSetDist)", NULL);
+
+    distStore(m, mapDistIndex(m, i, j), val);
+}
+
+/** \fn City mapGetCityChecked(Map m, int indice)
+ *  \brief Version vérifiée de mapGetCity (build de debug, TSP_CHECKS) : retourne l'objet City par son indice indice dans la Map m
  * \param m Map qui contient la ville que l'on cherche
  * \param indice Entier qui définit le numéro de l'objet City dans l'objet Map
  * \return City objet de type City
  */
 
-City mapGetCity(Map m, int indice)
+City mapGetCityChecked(Map m, int indice)
 {
     if(indice<0 || indice>=m->nbCities)
         throwErr("Map", "City index out of range (mapGetCity)", NULL);
@@ -307,22 +948,290 @@ Map mapCreateFromPoints(Point* villes, int nbVilles, Str name)
 
     m->name=strCopy(name);
 
-    throwMsg("Map", "Calculating lengths...");
+    mapLoadPoints(m, villes, nbVilles);
+
+    return m;
+}
+
+/** \fn static void *fillRows_thread(void *params)
+ *  \brief Fonction d'un thread de calcul de la matrice : calcule chaque distance (i, j>=i) de ses lignes une seule fois
+ * \param params pointeur vers la structure fill_params
+ *
+ * Les lignes du triangle raccourcissent, elles sont donc distribuées une sur step pour équilibrer les threads.
+ */
+
+static void *fillRows_thread(void *params)
+{
+    struct fill_params *param=(struct fill_params *)params;
+    Map m=param->m;
+    int n=m->distsSize;
+    double *buf=NULL;
+
+    if(m->distsType!=DISTS_DOUBLE)
+        buf=malloc(n*sizeof(double));
+
+    for(int i=param->first; i<n; i+=param->step)
+    {
+        size_t row=mapDistIndex(m, i, i); // position de la distance (i, i), début de la partie stockée de la ligne
 
-    double dists[nbVilles];
+        Point p={param->xs[i], param->ys[i]};
+
+        if(buf)
+        {
+            m->lengthRowFct(p, param->xs+i, param->ys+i, buf, n-i);
+            distStoreRow(m, row, buf, n-i);
+        }
+        else
+            m->lengthRowFct(p, param->xs+i, param->ys+i, (double*)m->dists+row, n-i);
+    }
+
+    free(buf);
+    return NULL;
+}
+
+/** \fn void mapLoadPoints(Map m, Point* villes, int nbVilles)
+ *  \brief Remplit une Map vide avec un tableau de Point, les distances sont calculées directement dans sa matrice
+ * \param m Objet de type Map sans villes
+ * \param villes Objet de type Point* contenant les références de nbVilles Point
+ * \param nbVilles nombre d'objet de type Point passés en paramètres
+ *
+ * Si la matrice dépasse LAZY_DISTS_BYTES (ou avec setDistsLazy), seules les coordonnées sont gardées et les distances sont calculées à la demande.
+ */
+
+void mapLoadPoints(Map m, Point* villes, int nbVilles)
+{
+    if(m->dists || m->xs)
+        throwErr("Map", "Distances already allocated (mapLoadPoints)", NULL);
+
+    double *xs=malloc(nbVilles*sizeof(double));
+    double *ys=malloc(nbVilles*sizeof(double));
+
+    if((!xs || !ys) && nbVilles>0)
+        throwErr("Map", "Not enough memory for the points (mapLoadPoints)", NULL);
+
+    for(int i=0; i<nbVilles; i++) // coordonnées rangées par axe pour les noyaux de distances ligne par ligne
+    {
+        xs[i]=villes[i].x;
+        ys[i]=villes[i].y;
+    }
+
+    if(distsLazy || distsCount(nbVilles, DISTS_TRIANGLE)*distsElemSize(m->distsType)>LAZY_DISTS_BYTES)
+    {
+        throwMsg("Map", "Distances will be computed on demand...");
+
+        m->xs=xs;
+        m->ys=ys;
+        m->distsSize=nbVilles;
+        m->distsLayout=DISTS_LAZY;
+    }
+    else
+    {
+        mapAllocDists(m, nbVilles, DISTS_TRIANGLE); // les longueurs sont symétriques
+
+        if(m->distsType==DISTS_Q16 && nbVilles>0)
+        {
+            Point min=villes[0], max=villes[0];
+
+            for(int i=1; i<nbVilles; i++)
+            {
+                min.x=fmin(min.x, villes[i].x);
+                min.y=fmin(min.y, villes[i].y);
+                max.x=fmax(max.x, villes[i].x);
+                max.y=fmax(max.y, villes[i].y);
+            }
+
+            if(m->lengthType==GEO) // sur la sphère, la diagonale de la boîte n'est pas la plus grande longueur
+                mapSetDistsScale(m, GEO_MAX_LENGTH);
+            else
+                mapSetDistsScale(m, m->lengthFct(min, max)); // aucune longueur ne dépasse la diagonale de la boîte englobante
+        }
+
+        throwMsg("Map", "Calculating lengths...");
+
+        int nbThreads=nbVilles>=FILL_MT_MIN_CITIES ? getNbThreads() : 1;
+        pthread_t thread[nbThreads];
+        struct fill_params params[nbThreads];
+
+        for(int t=0; t<nbThreads; t++)
+        {
+            params[t].m=m;
+            params[t].xs=xs;
+            params[t].ys=ys;
+            params[t].first=t;
+            params[t].step=nbThreads;
+        }
+
+        for(int t=1; t<nbThreads; t++)
+            pthread_create(&thread[t], NULL, fillRows_thread, &params[t]);
+
+        fillRows_thread(&params[0]); // le thread principal traite aussi sa part
+
+        for(int t=1; t<nbThreads; t++)
+            pthread_join(thread[t], NULL);
+
+        free(xs);
+        free(ys);
+    }
 
     for(int i=0; i<nbVilles; i++)
+        mapAddCity(m, cityCreate(true, villes[i]));
+}
+
+
+/** \fn static void *neighbours_thread(void *params)
+ *  \brief Fonction d'un thread de calcul des listes de voisins : garde les k plus courtes distances de chaque ligne par insertion
+ * \param params pointeur vers la structure neighbours_params
+ *
+ * Avec un arbre k-d, les voisins sont demandés à l'arbre (qui n'est que lu) au lieu de parcourir la ligne.
+ */
+
+static void *neighbours_thread(void *params)
+{
+    struct neighbours_params *param=(struct neighbours_params *)params;
+    Map m=param->m;
+    int n=m->distsSize;
+    int k=m->nbNeighbours;
+
+    if(param->tree)
     {
-        for (int j=0; j<nbVilles; j++)
-            dists[j]=length(villes[i],villes[j]);
+        for(int i=param->first; i<n; i+=param->step)
+        {
+            Point p={m->xs[i], m->ys[i]};
 
-        City ville=cityCreate(true, villes[i],dists,nbVilles);
-        mapAddCity(m,ville);
+            kdNearestK(param->tree, p, k, i, m->neighbours+(size_t)i*k);
+        }
+        return NULL;
     }
 
-    return m;
+    double *row=malloc(n*sizeof(double));
+    double *best=malloc(k*sizeof(double));
+
+    for(int i=param->first; i<n; i+=param->step)
+    {
+        int *nb=m->neighbours+(size_t)i*k;
+        int cpt=0;
+
+        mapDistsFrom(m, i, row);
+
+        for(int j=0; j<n; j++)
+        {
+            if(j==i || (cpt==k && row[j]>=best[k-1]))
+                continue;
+
+            int p=cpt<k ? cpt++ : k-1; // la plus lointaine des k est remplacée
+
+            while(p>0 && best[p-1]>row[j])
+            {
+                best[p]=best[p-1];
+                nb[p]=nb[p-1];
+                p--;
+            }
+
+            best[p]=row[j];
+            nb[p]=j;
+        }
+    }
+
+    free(best);
+    free(row);
+    return NULL;
+}
+
+/** \fn void mapBuildNeighbours(Map m, int k)
+ *  \brief Calcule pour chaque ville la liste de ses k plus proches voisins (listes candidates des heuristiques)
+ * \param m Objet de type Map
+ * \param k Nombre de voisins par ville (ramené à mapGetSize(m)-1)
+ *
+ * Chaque ligne de distances est parcourue une fois (O(n²k) au pire), les villes sont réparties entre les threads comme pour mapLoadPoints.
+ * Une Map de points sans matrice passe par un arbre k-d (O(nk log n) en pratique), avec les mêmes listes.
+ */
+
+void mapBuildNeighbours(Map m, int k)
+{
+    int n=m->distsSize;
+
+    if(k>n-1)
+        k=n-1;
+    if(k<0)
+        k=0;
+
+    if(m->nbNeighbours==k && m->neighbours)
+        return;
+
+    throwMsg("Map", "Building neighbour lists...");
+
+    if(!mapIsMapped(m, m->neighbours))
+        free(m->neighbours);
+
+    m->neighbours=malloc((size_t)n*k*sizeof(int));
+    m->nbNeighbours=k;
+
+    if(k==0)
+        return;
+
+    int nbThreads=n>=FILL_MT_MIN_CITIES ? getNbThreads() : 1;
+    pthread_t thread[nbThreads];
+    struct neighbours_params params[nbThreads];
+    KdTree tree=m->xs && kdSupports(m->lengthType) ? kdCreate(m->xs, m->ys, n, m->lengthType) : NULL;
+
+    for(int t=0; t<nbThreads; t++)
+    {
+        params[t].m=m;
+        params[t].tree=tree;
+        params[t].first=t;
+        params[t].step=nbThreads;
+    }
+
+    for(int t=1; t<nbThreads; t++)
+        pthread_create(&thread[t], NULL, neighbours_thread, &params[t]);
+
+    neighbours_thread(&params[0]);
+
+    for(int t=1; t<nbThreads; t++)
+        pthread_join(thread[t], NULL);
+
+    if(tree)
+        kdDelete(tree);
 }
 
+/** \fn void mapUseNeighbours(Map m, int *neighbours, int k)
+ *  \brief Donne à la Map des listes de voisins déjà calculées (par exemple dans un fichier projeté)
+ * \param m Objet de type Map
+ * \param neighbours k voisins par ville, ville par ville
+ * \param k Nombre de voisins par ville
+ */
+
+void mapUseNeighbours(Map m, int *neighbours, int k)
+{
+    if(!mapIsMapped(m, m->neighbours))
+        free(m->neighbours);
+
+    m->neighbours=neighbours;
+    m->nbNeighbours=k;
+}
+
+/** \fn const int *mapGetNeighbours(Map m, int i)
+ *  \brief Retourne les plus proches voisins de la ville i, du plus proche au plus lointain
+ * \param m Objet de type Map (listes calculées par mapBuildNeighbours)
+ * \param i Indice de la ville
+ * \return Tableau de mapGetNbNeighbours(m) indices de villes
+ */
+
+const int *mapGetNeighbours(Map m, int i)
+{
+    return m->neighbours+(size_t)i*m->nbNeighbours;
+}
+
+/** \fn int mapGetNbNeighbours(Map m)
+ *  \brief Retourne le nombre de voisins par ville des listes de la Map
+ * \param m Objet de type Map
+ * \return Nombre de voisins (0 si les listes ne sont pas calculées)
+ */
+
+int mapGetNbNeighbours(Map m)
+{
+    return m->neighbours ? m->nbNeighbours : 0;
+}
 
 /** \fn Map mapCreateRandom(int nbVilles)
  *  \brief Crée un objet de type Map avec nbVilles objets City avec des points générés aléatoirements
@@ -332,7 +1241,7 @@ Map mapCreateFromPoints(Point* villes, int nbVilles, Str name)
 
 Map mapCreateRandom(int nbVilles)
 {
-    Point villes[nbVilles];
+    Point *villes=malloc(nbVilles*sizeof(Point)); // pas sur la pile : peut contenir des millions de villes
 
     for(int i=0; i<nbVilles; i++)
     {
@@ -359,6 +1268,7 @@ Map mapCreateRandom(int nbVilles)
 
     free(txt);
     free(txt2);
+    free(villes);
 
     return m;
 }
@@ -448,4 +1358,4 @@ void mapDraw(Map m)
             printf("-");
         printf("\n");
     }
-}
+}
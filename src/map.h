@@ -9,11 +9,136 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include <stdint.h>
+
 #include "city.h"
 #include "string.h"
 
 typedef struct _Map * Map;
 
+/**
+* \def DISTS_FULL
+* \brief Matrice de distances complète, n x n distances.
+*/
+
+#define DISTS_FULL 0
+
+/**
+* \def DISTS_TRIANGLE
+* \brief Matrice de distances symétrique dont seul le triangle supérieur est stocké, n(n+1)/2 distances.
+*/
+
+#define DISTS_TRIANGLE 1
+
+/**
+* \def DISTS_LAZY
+* \brief Pas de matrice : la Map garde les coordonnées des villes et calcule les distances à la demande.
+*/
+
+#define DISTS_LAZY 2
+
+/**
+* \def DISTS_DOUBLE
+* \brief Distances stockées en double (8 octets).
+*/
+
+#define DISTS_DOUBLE 0
+
+/**
+* \def DISTS_FLOAT
+* \brief Distances stockées en float (4 octets).
+*/
+
+#define DISTS_FLOAT 1
+
+/**
+* \def DISTS_INT
+* \brief Distances arrondies à l'entier le plus proche et stockées sur 32 bits (distances TSPLIB).
+*/
+
+#define DISTS_INT 2
+
+/**
+* \def DISTS_Q16
+* \brief Distances quantifiées sur 16 bits avec un pas propre à chaque Map.
+*/
+
+#define DISTS_Q16 3
+
+/** \fn void setDistsType(int val)
+ *  \brief Met la précision de stockage des distances pour les Map créées ensuite
+ *  \param val DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+void setDistsType(int);
+
+/** \fn void setDistsLazy(bool val)
+ *  \brief Force le calcul des distances à la demande pour les Map de points créées ensuite
+ *  \param val true pour ne garder que les coordonnées, false pour laisser la taille de la Map décider
+ */
+
+void setDistsLazy(bool);
+
+/** \struct _Map
+ *  \brief Structure représentant une Map contenant les villes.
+ *
+ *  Définie dans l'en-tête pour que mapDist et mapGetCity soient inline : ne pas accéder aux champs hors de map.c et de ces accesseurs.
+ */
+
+struct _Map
+{
+    bool isPos; /*!< Booléen qui vaut true lorsque la map est generée par des City déterminées par des points (et non une matrice de distance seulement). */
+    City* cities; /*!< Tableau de villes extensible. */
+    int nbCities; /*!< Nombre de villes dans le tableau. */
+    int nbCitiesMax; /*!< Nombre de villes maximum. */
+    void *dists; /*!< Matrice de distances d'un seul bloc (ligne par ligne), alignée sur une ligne de cache. */
+    int distsSize; /*!< Nombre de villes prévues par la matrice de distances. */
+    int distsLayout; /*!< Stockage de la matrice : DISTS_FULL (n x n), DISTS_TRIANGLE (triangle supérieur, n(n+1)/2 distances) ou DISTS_LAZY (pas de matrice). */
+    double *xs; /*!< Abscisses des villes, gardées pour calculer les distances en mode DISTS_LAZY (NULL sinon). */
+    double *ys; /*!< Ordonnées des villes en mode DISTS_LAZY (NULL sinon). */
+    int lengthType; /*!< Distance entre les points de la Map (EUCLIDIAN, MANHATTAN...), fixée à sa création. */
+    LengthFct lengthFct; /*!< Noyau de distance entre deux points choisi pour lengthType. */
+    LengthRowFct lengthRowFct; /*!< Noyau de distances d'un point vers une ligne de points choisi pour lengthType. */
+    int distsType; /*!< Précision des distances stockées : DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16. */
+    double distsScale; /*!< Pas de quantification des distances DISTS_Q16 (distance = valeur stockée * distsScale). */
+    bool distsClamped; /*!< Vaut true si une distance trop grande a été tronquée (DISTS_Q16). */
+    Str name; /*!< Nom du fichier TSP associé à la Map. */
+    City **paths; /*!< Tableau à deux dimensions contenant les chemins de obtenus par chaque algorithme. */
+    double *duration; /*!< Tableau stockant les temps d'exécution de chaque algorithme. */
+    City **improvedPaths; /*!< Chemin de chaque algorithme après les heuristiques d'amélioration (NULL si aucune n'a été appliquée). */
+    double *improvedDuration; /*!< Temps d'exécution de chaque algorithme, améliorations comprises. */
+    int startCity; /*!< L'index de la ville de départ de la Map. */
+    int *neighbours; /*!< Listes des nbNeighbours plus proches voisins de chaque ville, triées par distance croissante (NULL si non calculées). */
+    int nbNeighbours; /*!< Nombre de voisins par ville dans neighbours. */
+    void *mapping; /*!< Fichier projeté en mémoire (cache binaire) dans lequel pointent dists, xs, ys ou neighbours (NULL sinon). */
+    size_t mappingSize; /*!< Taille du fichier projeté. */
+};
+
+/** \fn static inline size_t mapDistIndex(Map m, int i, int j)
+ *  \brief Fonction d'indexation de la matrice : position de la distance (i, j) dans le bloc de la Map
+ * \param m Objet de type Map
+ * \param i Indice de la première ville
+ * \param j Indice de la deuxième ville
+ * \return Position dans m->dists
+ *
+ * En mode triangle, la ligne i ne contient que les colonnes j>=i et commence à i*n-i(i-1)/2.
+ */
+
+static inline size_t mapDistIndex(Map m, int i, int j)
+{
+    if(m->distsLayout==DISTS_TRIANGLE)
+    {
+        if(i>j)
+        {
+            int tmp=i;
+            i=j;
+            j=tmp;
+        }
+        return (size_t)i*(2*(size_t)m->distsSize-i-1)/2+j;
+    }
+    return (size_t)i*m->distsSize+j;
+}
+
 /** \fn Map mapCreate()
  *  \brief mapCreate crée une instance de Map (avec allocation mémoire)
  *  \return objet de type Map
@@ -73,6 +198,42 @@ double mapGetDuration(Map, int);
 
 void mapSetDuration(Map, int, double);
 
+/** \fn City *mapGetImprovedPath(Map m, int i)
+ * \brief Retourne le chemin de l'algorithme i après les heuristiques d'amélioration
+ * \param m Map contenant le chemin
+ * \param i Entier passé en index désignant l'algorithme
+ * \return tableau de City, NULL si aucune amélioration n'a été appliquée
+ */
+
+City *mapGetImprovedPath(Map, int);
+
+/** \fn void mapSetImprovedPath(Map m, int i, City *path)
+ * \brief Modifie le chemin amélioré de l'algorithme i (le chemin de l'algorithme, mapGetPath, n'est pas modifié)
+ * \param m Map contenant le chemin
+ * \param i Entier passé en index désignant l'algorithme
+ * \param path tableau de City représentant le chemin amélioré
+ */
+
+void mapSetImprovedPath(Map, int, City*);
+
+/** \fn double mapGetImprovedDuration(Map m, int i)
+ * \brief Retourne le temps d'exécution de l'algorithme i, améliorations comprises
+ * \param m Map stockant le tableau improvedDuration
+ * \param i Entier passé en index désignant l'algorithme
+ * \return nombre de type double (précision)
+ */
+
+double mapGetImprovedDuration(Map, int);
+
+/** \fn void mapSetImprovedDuration(Map m, int i, double val)
+ * \brief Modifie le tableau improvedDuration
+ * \param m Map stockant le tableau improvedDuration
+ * \param i Entier passé en index désignant l'algorithme
+ * \param val temps d'exécution de l'algorithme et des améliorations
+ */
+
+void mapSetImprovedDuration(Map, int, double);
+
 /** \fn double mapGetStartCity(Map m)
  * \brief Retourne la ville de départ de la Map
  * \param m Map contenant la ville de depart
@@ -111,14 +272,281 @@ void mapDeleteRec(Map);
 
 void mapAddCity(Map, City);
 
-/** \fn City mapGetCity(Map m, int indice)
- *  \brief Retourne l'objet City par son indice indice dans la Map m
+/** \fn void mapAllocDists(Map m, int nbVilles, int layout)
+ *  \brief Alloue la matrice de distances de la Map d'un seul bloc
+ * \param m Objet de type Map (sans matrice de distances)
+ * \param nbVilles Nombre de villes que contiendra la Map
+ * \param layout DISTS_FULL pour une matrice complète, DISTS_TRIANGLE pour une matrice symétrique (moitié de la mémoire)
+ */
+
+void mapAllocDists(Map, int, int);
+
+/** \fn void mapUnpackDists(Map m)
+ *  \brief Passe la matrice d'une Map du stockage triangle au stockage complet (matrice finalement non symétrique)
+ * \param m Objet de type Map
+ */
+
+void mapUnpackDists(Map);
+
+/** \fn void mapConvertDists(Map m, int type)
+ *  \brief Change la précision de stockage d'une matrice déjà remplie ; en DISTS_Q16, le pas est choisi d'après la plus grande distance
+ * \param m Objet de type Map (matrice DISTS_FULL ou DISTS_TRIANGLE)
+ * \param type DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+void mapConvertDists(Map, int);
+
+/** \fn void mapAttachMapping(Map m, void *addr, size_t size)
+ *  \brief Confie à la Map un fichier projeté en mémoire (voir fileMap) : les blocs qui y pointent ne sont pas libérés, le fichier est libéré par mapDelete
+ * \param m Objet de type Map
+ * \param addr Contenu du fichier
+ * \param size Taille du fichier
+ */
+
+void mapAttachMapping(Map, void *, size_t);
+
+/** \fn void mapUseDists(Map m, void *dists, int nbVilles, int layout, double scale)
+ *  \brief Donne à la Map une matrice de distances déjà remplie (par exemple dans un fichier projeté) au lieu de l'allouer
+ * \param m Objet de type Map (sans matrice de distances, précision déjà choisie)
+ * \param dists Bloc de distances au format de mapGetDistsData
+ * \param nbVilles Nombre de villes que contiendra la Map
+ * \param layout DISTS_FULL ou DISTS_TRIANGLE
+ * \param scale Pas de quantification (DISTS_Q16)
+ */
+
+void mapUseDists(Map, void *, int, int, double);
+
+/** \fn void mapUseCoords(Map m, double *xs, double *ys, int nbVilles)
+ *  \brief Passe la Map en mode DISTS_LAZY avec des coordonnées déjà rangées par axe (par exemple dans un fichier projeté)
+ * \param m Objet de type Map (sans matrice de distances)
+ * \param xs Abscisses des nbVilles villes
+ * \param ys Ordonnées des nbVilles villes
+ * \param nbVilles Nombre de villes que contiendra la Map
+ */
+
+void mapUseCoords(Map, double *, double *, int);
+
+/** \fn const void *mapGetDistsData(Map m, size_t *bytes)
+ *  \brief Retourne le bloc de la matrice de distances tel qu'il est stocké (voir mapGetDistsLayout et mapGetDistsType)
+ * \param m Objet de type Map
+ * \param bytes Taille du bloc en octets (sortie, 0 en mode DISTS_LAZY)
+ * \return Le bloc de distances, NULL en mode DISTS_LAZY
+ */
+
+const void *mapGetDistsData(Map, size_t *);
+
+/** \fn double mapGetDistsScale(Map m)
+ *  \brief Retourne le pas de quantification des distances DISTS_Q16
+ * \param m Objet de type Map
+ * \return Pas de quantification
+ */
+
+double mapGetDistsScale(Map);
+
+/** \fn const double *mapGetXs(Map m)
+ *  \brief Retourne les abscisses des villes d'une Map DISTS_LAZY, rangées par axe pour les calculs ligne par ligne
+ * \param m Objet de type Map
+ * \return Tableau de mapGetSize(m) abscisses, NULL si la Map a une matrice de distances
+ */
+
+const double *mapGetXs(Map);
+
+/** \fn const double *mapGetYs(Map m)
+ *  \brief Retourne les ordonnées des villes d'une Map DISTS_LAZY
+ * \param m Objet de type Map
+ * \return Tableau de mapGetSize(m) ordonnées, NULL si la Map a une matrice de distances
+ */
+
+const double *mapGetYs(Map);
+
+/** \fn void mapBuildNeighbours(Map m, int k)
+ *  \brief Calcule pour chaque ville la liste de ses k plus proches voisins (listes candidates des heuristiques)
+ * \param m Objet de type Map
+ * \param k Nombre de voisins par ville (ramené à mapGetSize(m)-1)
+ */
+
+void mapBuildNeighbours(Map, int);
+
+/** \fn void mapUseNeighbours(Map m, int *neighbours, int k)
+ *  \brief Donne à la Map des listes de voisins déjà calculées (par exemple dans un fichier projeté)
+ * \param m Objet de type Map
+ * \param neighbours k voisins par ville, ville par ville
+ * \param k Nombre de voisins par ville
+ */
+
+void mapUseNeighbours(Map, int *, int);
+
+/** \fn const int *mapGetNeighbours(Map m, int i)
+ *  \brief Retourne les plus proches voisins de la ville i, du plus proche au plus lointain
+ * \param m Objet de type Map (listes calculées par mapBuildNeighbours)
+ * \param i Indice de la ville
+ * \return Tableau de mapGetNbNeighbours(m) indices de villes
+ */
+
+const int *mapGetNeighbours(Map, int);
+
+/** \fn int mapGetNbNeighbours(Map m)
+ *  \brief Retourne le nombre de voisins par ville des listes de la Map
+ * \param m Objet de type Map
+ * \return Nombre de voisins (0 si les listes ne sont pas calculées)
+ */
+
+int mapGetNbNeighbours(Map);
+
+/** \fn int mapGetDistsLayout(Map m)
+ *  \brief Retourne le mode de stockage de la matrice de distances
+ * \param m Objet de type Map
+ * \return DISTS_FULL, DISTS_TRIANGLE ou DISTS_LAZY
+ */
+
+int mapGetDistsLayout(Map);
+
+/** \fn bool mapIsSymmetric(Map m)
+ *  \brief Indique si les distances de la Map sont symétriques (d(i, j) == d(j, i) pour toutes les villes)
+ * \param m Objet de type Map
+ * \return true sauf pour une matrice DISTS_FULL non symétrique (instance ATSP)
+ */
+
+bool mapIsSymmetric(Map);
+
+/** \fn int mapGetDistsType(Map m)
+ *  \brief Retourne la précision de stockage de la matrice de distances
+ * \param m Objet de type Map
+ * \return DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+int mapGetDistsType(Map);
+
+/** \fn void mapSetDistsType(Map m, int type)
+ *  \brief Choisit la précision de stockage de la matrice de distances de la Map (à la place du réglage global)
+ * \param m Objet de type Map (avant l'allocation de la matrice)
+ * \param type DISTS_DOUBLE, DISTS_FLOAT, DISTS_INT ou DISTS_Q16
+ */
+
+void mapSetDistsType(Map, int);
+
+/** \fn void mapSetDistsScale(Map m, double maxDist)
+ *  \brief Choisit le pas de quantification DISTS_Q16 pour que maxDist soit la plus grande distance représentable
+ * \param m Objet de type Map (avant le remplissage de la matrice)
+ * \param maxDist Borne supérieure des distances de la Map
+ */
+
+void mapSetDistsScale(Map, double);
+
+/** \fn static inline double mapDistUnchecked(Map m, int i, int j)
+ *  \brief Retourne la distance entre les villes d'indices i et j, lue directement dans la matrice (ou calculée en mode DISTS_LAZY), sans contrôle des indices
+ * \param m Objet de type Map
+ * \param i Indice de la première ville
+ * \param j Indice de la deuxième ville
+ * \return Distance entre les deux villes
+ */
+
+static inline double mapDistUnchecked(Map m, int i, int j)
+{
+    if(m->distsLayout==DISTS_LAZY)
+    {
+        Point pi={m->xs[i], m->ys[i]}, pj={m->xs[j], m->ys[j]};
+        return m->lengthFct(pi, pj);
+    }
+
+    size_t k=mapDistIndex(m, i, j);
+
+    switch(m->distsType)
+    {
+    case DISTS_FLOAT:
+        return ((float*)m->dists)[k];
+    case DISTS_INT:
+        return ((int32_t*)m->dists)[k];
+    case DISTS_Q16:
+        return ((uint16_t*)m->dists)[k]*m->distsScale;
+    default:
+        return ((double*)m->dists)[k];
+    }
+}
+
+/** \fn double mapDistChecked(Map m, int i, int j)
+ *  \brief Version vérifiée de mapDist (build de debug, TSP_CHECKS) : contrôle les indices avant la lecture
+ * \param m Objet de type Map
+ * \param i Indice de la première ville
+ * \param j Indice de la deuxième ville
+ * \return Distance entre les deux villes
+ */
+
+double mapDistChecked(Map, int, int);
+
+/** \fn void mapSetLengthType(Map m, int type)
+ *  \brief Choisit la distance entre les points de la Map et ses noyaux de calcul (une fois pour toute la Map)
+ * \param m Objet de type Map (avant le chargement des points)
+ * \param type EUCLIDIAN, MANHATTAN ou une distance TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D)
+ */
+
+void mapSetLengthType(Map, int);
+
+/** \fn int mapGetLengthType(Map m)
+ *  \brief Retourne la distance utilisée entre les points de la Map
+ * \param m Objet de type Map
+ * \return EUCLIDIAN, MANHATTAN ou une distance TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D), voir point.h
+ */
+
+int mapGetLengthType(Map);
+
+/** \fn void mapDistsFrom(Map m, int i, double *out)
+ *  \brief Remplit out avec les distances de la ville i à toutes les villes de la Map
+ * \param m Objet de type Map
+ * \param i Indice de la ville
+ * \param out Tableau de mapGetSize(m) distances
+ */
+
+void mapDistsFrom(Map, int, double *);
+
+/** \fn void mapSetDist(Map m, int i, int j, double val)
+ *  \brief Ecrit la distance entre les villes d'indices i et j dans la matrice
+ * \param m Objet de type Map
+ * \param i Indice de la première ville
+ * \param j Indice de la deuxième ville
+ * \param val Distance entre les deux villes
+ */
+
+void mapSetDist(Map, int, int, double);
+
+/** \fn static inline City mapGetCityUnchecked(Map m, int indice)
+ *  \brief Retourne l'objet City par son indice indice dans la Map m, sans contrôle de l'indice
+ * \param m Map qui contient la ville que l'on cherche
+ * \param indice Entier qui définit le numéro de l'objet City dans l'objet Map
+ * \return City objet de type City
+ */
+
+static inline City mapGetCityUnchecked(Map m, int indice)
+{
+    return m->cities[indice];
+}
+
+/** \fn City mapGetCityChecked(Map m, int indice)
+ *  \brief Version vérifiée de mapGetCity (build de debug, TSP_CHECKS) : retourne l'objet City par son indice indice dans la Map m
  * \param m Map qui contient la ville que l'on cherche
  * \param indice Entier qui définit le numéro de l'objet City dans l'objet Map
  * \return City objet de type City
  */
 
-City mapGetCity(Map,int);
+City mapGetCityChecked(Map,int);
+
+/**
+* \def mapDist(m, i, j)
+* \brief Distance entre les villes d'indices i et j : inline sans contrôle, ou vérifiée si TSP_CHECKS est défini (Makefile.db).
+*/
+
+/**
+* \def mapGetCity(m, indice)
+* \brief Ville d'indice indice : inline sans contrôle, ou vérifiée si TSP_CHECKS est défini (Makefile.db).
+*/
+
+#ifdef TSP_CHECKS
+#define mapDist(m, i, j) mapDistChecked(m, i, j)
+#define mapGetCity(m, indice) mapGetCityChecked(m, indice)
+#else
+#define mapDist(m, i, j) mapDistUnchecked(m, i, j)
+#define mapGetCity(m, indice) mapGetCityUnchecked(m, indice)
+#endif
 
 /** \fn void mapSetCity(Map m, City c, int indice)
  *  \brief Met l'objet City c dans l'objet Map avec l'indice indice
@@ -162,6 +590,15 @@ void mapDataDump(Map);
 
 Map mapCreateFromPoints(Point*, int, Str);
 
+/** \fn void mapLoadPoints(Map m, Point* villes, int nbVilles)
+ *  \brief Remplit une Map vide avec un tableau de Point, les distances sont calculées directement dans sa matrice
+ * \param m Objet de type Map sans villes
+ * \param villes Objet de type Point* contenant les références de nbVilles Point
+ * \param nbVilles nombre d'objet de type Point passés en paramètres
+ */
+
+void mapLoadPoints(Map, Point*, int);
+
 /** \fn Map mapCreateRandom(int nbVilles)
  *  \brief Crée un objet de type Map avec nbVilles objets City avec des points générés aléatoirements
  * \param nbVilles nombre de villes que l'objet Map aura
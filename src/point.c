@@ -15,19 +15,42 @@
 
 #include "point.h"
 
-bool lengthType;
+/**
+* \def GEO_PI
+* \brief Valeur de pi imposée par TSPLIB pour les coordonnées GEO.
+*/
 
-/** \fn void setLengthType(bool val)
- *  \brief Met le type de longueur pour le programme
- *  \param val Bool, val==1 => longueur de manhattan, val==0 => longueur euclidienne
- *  si on veut des longueurs Manhattan val est à 1, si on veut des longueurs Euclidienne, val est à 0
+#define GEO_PI 3.141592
+
+/**
+* \def GEO_RRR
+* \brief Rayon de la Terre (km) imposé par TSPLIB pour les distances GEO.
+*/
+
+#define GEO_RRR 6378.388
+
+int lengthType;
+
+/** \fn void setLengthType(int val)
+ *  \brief Met le type de longueur pour le programme (pris par les Map créées ensuite)
+ *  \param val MANHATTAN (1) => longueur de manhattan, EUCLIDIAN (0) => longueur euclidienne
  */
 
-void setLengthType(bool val)   // fonction pour sélectionner le type de distance (euclidienne ou Manhattan)
+void setLengthType(int val)   // fonction pour sélectionner le type de distance (euclidienne ou Manhattan)
 {
     lengthType=val;
 }
 
+/** \fn int getLengthType()
+ *  \brief Retourne le type de longueur du programme
+ *  \return MANHATTAN ou EUCLIDIAN
+ */
+
+int getLengthType()
+{
+    return lengthType;
+}
+
 /** \fn double lengthEuc(Point p1, Point p2)
  *  \brief renvoie la distance Euclidienne de deux points
  * \param p1 Objet de type Point
@@ -51,19 +74,299 @@ double lengthMan(Point p1, Point p2)   // distance de Manhattan
 }
 
 /** \fn double length(Point p1, Point p2)
- *  \brief renvoie la distance de deux points selon le bool lengthType
+ *  \brief renvoie la distance de deux points selon lengthType (préférer le noyau choisi par lengthGetFct dans les boucles)
  * \param p1 Objet de type Point
  * \param p2 Objet de type Point
  * \return Double qui est la distance entre deux points
  */
 double length(Point p1, Point p2)
 {
-    if (lengthType)
+    if (lengthType==MANHATTAN)
         return lengthMan(p1, p2);
     else
         return lengthEuc(p1,p2);
 }
 
+/** \fn void lengthEucRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief calcule d'un coup les distances euclidiennes entre p et n points rangés par coordonnées (xs, ys)
+ * \param p Objet de type Point
+ * \param xs Abscisses des n points
+ * \param ys Ordonnées des n points
+ * \param out Tableau de n distances à remplir (ne doit pas chevaucher xs et ys)
+ * \param n Nombre de points
+ *
+ * Boucle sans appel ni branchement, vectorisée par le compilateur (-O3 -fno-math-errno).
+ */
+
+void lengthEucRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+    {
+        double dx=xs[j]-p.x;
+        double dy=ys[j]-p.y;
+        out[j]=sqrt(dx*dx+dy*dy);
+    }
+}
+
+/** \fn void lengthManRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief calcule d'un coup les distances de Manhattan entre p et n points rangés par coordonnées (xs, ys)
+ * \param p Objet de type Point
+ * \param xs Abscisses des n points
+ * \param ys Ordonnées des n points
+ * \param out Tableau de n distances à remplir (ne doit pas chevaucher xs et ys)
+ * \param n Nombre de points
+ *
+ * Même arrondi que lengthMan (chaque écart est tronqué à l'entier).
+ */
+
+void lengthManRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+        out[j]=abs((int)(xs[j]-p.x))+abs((int)(ys[j]-p.y));
+}
+
+/** \fn static int nint(double x)
+ *  \brief arrondi à l'entier le plus proche des longueurs TSPLIB (x>=0)
+ * \param x Longueur réelle
+ * \return Longueur entière
+ */
+
+static int nint(double x)
+{
+    return (int)(x+0.5);
+}
+
+/** \fn static double geoRad(double x)
+ *  \brief convertit une coordonnée TSPLIB GEO (DDD.MM, degrés et minutes) en radians
+ * \param x Coordonnée GEO
+ * \return Angle en radians
+ */
+
+static double geoRad(double x)
+{
+    int deg=(int)x;
+    double min=x-deg;
+    return GEO_PI*(deg+5.0*min/3.0)/180.0;
+}
+
+/** \fn double lengthEuc2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB EUC_2D de deux points (euclidienne arrondie à l'entier le plus proche)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthEuc2D(Point p1, Point p2)
+{
+    return nint(lengthEuc(p1, p2));
+}
+
+/** \fn double lengthCeil2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB CEIL_2D de deux points (euclidienne arrondie à l'entier supérieur)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthCeil2D(Point p1, Point p2)
+{
+    return ceil(lengthEuc(p1, p2));
+}
+
+/** \fn double lengthAtt(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB ATT (pseudo-euclidienne) de deux points
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthAtt(Point p1, Point p2)
+{
+    double dx=p2.x-p1.x, dy=p2.y-p1.y;
+    double r=sqrt((dx*dx+dy*dy)/10.0);
+    int t=nint(r);
+    return t<r ? t+1 : t;
+}
+
+/** \fn double lengthMan2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB MAN_2D de deux points (Manhattan arrondie à l'entier le plus proche)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthMan2D(Point p1, Point p2)
+{
+    return nint(fabs(p2.x-p1.x)+fabs(p2.y-p1.y));
+}
+
+/** \fn double lengthMax2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB MAX_2D de deux points (plus grand écart arrondi à l'entier le plus proche)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthMax2D(Point p1, Point p2)
+{
+    return nint(fmax(fabs(p2.x-p1.x), fabs(p2.y-p1.y)));
+}
+
+/** \fn double lengthGeo(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB GEO de deux points (x latitude, y longitude, en km sur la sphère terrestre)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière (0 pour deux points confondus)
+ */
+
+double lengthGeo(Point p1, Point p2)
+{
+    if(pointEquals(p1, p2))
+        return 0;
+
+    double lat1=geoRad(p1.x), lon1=geoRad(p1.y);
+    double lat2=geoRad(p2.x), lon2=geoRad(p2.y);
+    double q1=cos(lon1-lon2);
+    double q2=cos(lat1-lat2);
+    double q3=cos(lat1+lat2);
+    return (int)(GEO_RRR*acos(0.5*((1.0+q1)*q2-(1.0-q1)*q3))+1.0);
+}
+
+/** \fn void lengthEuc2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthEuc2D (voir lengthEucRow)
+ */
+
+void lengthEuc2DRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+    {
+        double dx=xs[j]-p.x;
+        double dy=ys[j]-p.y;
+        out[j]=(int)(sqrt(dx*dx+dy*dy)+0.5);
+    }
+}
+
+/** \fn void lengthCeil2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthCeil2D (voir lengthEucRow)
+ */
+
+void lengthCeil2DRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+    {
+        double dx=xs[j]-p.x;
+        double dy=ys[j]-p.y;
+        out[j]=ceil(sqrt(dx*dx+dy*dy));
+    }
+}
+
+/** \fn void lengthAttRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthAtt (voir lengthEucRow)
+ */
+
+void lengthAttRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+    {
+        double dx=xs[j]-p.x;
+        double dy=ys[j]-p.y;
+        double r=sqrt((dx*dx+dy*dy)/10.0);
+        double t=(int)(r+0.5);
+        out[j]=t<r ? t+1 : t;
+    }
+}
+
+/** \fn void lengthMan2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthMan2D (voir lengthEucRow)
+ */
+
+void lengthMan2DRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+        out[j]=(int)(fabs(xs[j]-p.x)+fabs(ys[j]-p.y)+0.5);
+}
+
+/** \fn void lengthMax2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthMax2D (voir lengthEucRow)
+ */
+
+void lengthMax2DRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+        out[j]=(int)(fmax(fabs(xs[j]-p.x), fabs(ys[j]-p.y))+0.5);
+}
+
+/** \fn void lengthGeoRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthGeo (non vectorisée : acos)
+ */
+
+void lengthGeoRow(Point p, const double *restrict xs, const double *restrict ys, double *restrict out, int n)
+{
+    for(int j=0; j<n; j++)
+    {
+        Point q={xs[j], ys[j]};
+        out[j]=lengthGeo(p, q);
+    }
+}
+
+/** \fn LengthFct lengthGetFct(int type)
+ *  \brief renvoie la fonction de distance entre deux points spécialisée pour type, à choisir une fois au lieu de tester lengthType à chaque appel
+ * \param type EUCLIDIAN, MANHATTAN ou un type TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D)
+ * \return Fonction de distance
+ */
+
+LengthFct lengthGetFct(int type)
+{
+    switch(type)
+    {
+    case MANHATTAN:
+        return lengthMan;
+    case EUC_2D:
+        return lengthEuc2D;
+    case CEIL_2D:
+        return lengthCeil2D;
+    case GEO:
+        return lengthGeo;
+    case ATT:
+        return lengthAtt;
+    case MAN_2D:
+        return lengthMan2D;
+    case MAX_2D:
+        return lengthMax2D;
+    default:
+        return lengthEuc;
+    }
+}
+
+/** \fn LengthRowFct lengthGetRowFct(int type)
+ *  \brief renvoie le noyau de distances d'un point vers une ligne de points spécialisé pour type
+ * \param type EUCLIDIAN, MANHATTAN ou un type TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D)
+ * \return Noyau de distances ligne par ligne
+ */
+
+LengthRowFct lengthGetRowFct(int type)
+{
+    switch(type)
+    {
+    case MANHATTAN:
+        return lengthManRow;
+    case EUC_2D:
+        return lengthEuc2DRow;
+    case CEIL_2D:
+        return lengthCeil2DRow;
+    case GEO:
+        return lengthGeoRow;
+    case ATT:
+        return lengthAttRow;
+    case MAN_2D:
+        return lengthMan2DRow;
+    case MAX_2D:
+        return lengthMax2DRow;
+    default:
+        return lengthEucRow;
+    }
+}
+
 /** \fn double pointGetX(Point p)
  *  \brief retourne l'abscisse du Point p
  * \param p Objet de type Point
@@ -17,6 +17,55 @@
 #define MANHATTAN 1
 #define EUCLIDIAN 0
 
+/**
+* \def EUC_2D
+* \brief Distance TSPLIB EUC_2D : euclidienne arrondie à l'entier le plus proche.
+*/
+
+#define EUC_2D 2
+
+/**
+* \def CEIL_2D
+* \brief Distance TSPLIB CEIL_2D : euclidienne arrondie à l'entier supérieur.
+*/
+
+#define CEIL_2D 3
+
+/**
+* \def GEO
+* \brief Distance TSPLIB GEO : distance géographique en km, coordonnées en degrés.minutes (x latitude, y longitude).
+*/
+
+#define GEO 4
+
+/**
+* \def ATT
+* \brief Distance TSPLIB ATT : pseudo-euclidienne des instances att48 et att532.
+*/
+
+#define ATT 5
+
+/**
+* \def MAN_2D
+* \brief Distance TSPLIB MAN_2D : Manhattan arrondie à l'entier le plus proche.
+*/
+
+#define MAN_2D 6
+
+/**
+* \def MAX_2D
+* \brief Distance TSPLIB MAX_2D : plus grand écart des coordonnées arrondi à l'entier le plus proche.
+*/
+
+#define MAX_2D 7
+
+/**
+* \def GEO_MAX_LENGTH
+* \brief Plus grande distance GEO possible (deux points antipodaux) : (int)(GEO_RRR*pi+1), voir lengthGeo.
+*/
+
+#define GEO_MAX_LENGTH 20039
+
 
 /** \struct Coords
  * \brief Structure Coords (coordonnées) d'un Point par son abscisse x et son ordonnée y
@@ -30,13 +79,31 @@ typedef struct Coords
 
 typedef Coords Point;
 
-/** \fn void setLengthType(bool val)
- *  \brief Met le type de longueur pour le programme
- *  \param val Bool, val==1 => longueur de manhattan, val==0 => longueur euclidienne
- *  si on veut des longueurs Manhattan val est à 1, si on veut des longueurs Euclidienne, val est à 0
+/** \typedef LengthFct
+ * \brief Fonction de distance entre deux points (une par type de longueur)
+ */
+
+typedef double (*LengthFct)(Point, Point);
+
+/** \typedef LengthRowFct
+ * \brief Noyau calculant les distances d'un point vers n points rangés par coordonnées : (p, xs, ys, out, n)
  */
 
-void setLengthType(bool) ;
+typedef void (*LengthRowFct)(Point, const double *, const double *, double *, int);
+
+/** \fn void setLengthType(int val)
+ *  \brief Met le type de longueur pour le programme (pris par les Map créées ensuite)
+ *  \param val MANHATTAN (1) => longueur de manhattan, EUCLIDIAN (0) => longueur euclidienne
+ */
+
+void setLengthType(int) ;
+
+/** \fn int getLengthType()
+ *  \brief Retourne le type de longueur du programme
+ *  \return MANHATTAN ou EUCLIDIAN
+ */
+
+int getLengthType();
 
 /** \fn double lengthEuc(Point p1, Point p2)
  *  \brief renvoie la distance Euclidienne de deux points
@@ -57,13 +124,141 @@ double lengthEuc(Point, Point);
 double lengthMan(Point, Point);
 
 /** \fn double length(Point p1, Point p2)
- *  \brief renvoie la distance de deux points selon le bool lengthType
+ *  \brief renvoie la distance de deux points selon lengthType (préférer le noyau choisi par lengthGetFct dans les boucles)
  * \param p1 Objet de type Point
  * \param p2 Objet de type Point
  * \return Double qui est la distance entre deux points
  */
 
 double length(Point, Point);
+
+/** \fn void lengthEucRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief calcule d'un coup les distances euclidiennes entre p et n points rangés par coordonnées (xs, ys)
+ * \param p Objet de type Point
+ * \param xs Abscisses des n points
+ * \param ys Ordonnées des n points
+ * \param out Tableau de n distances à remplir (ne doit pas chevaucher xs et ys)
+ * \param n Nombre de points
+ */
+
+void lengthEucRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn void lengthManRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief calcule d'un coup les distances de Manhattan entre p et n points rangés par coordonnées (xs, ys)
+ * \param p Objet de type Point
+ * \param xs Abscisses des n points
+ * \param ys Ordonnées des n points
+ * \param out Tableau de n distances à remplir (ne doit pas chevaucher xs et ys)
+ * \param n Nombre de points
+ */
+
+void lengthManRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn double lengthEuc2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB EUC_2D de deux points (euclidienne arrondie à l'entier le plus proche)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthEuc2D(Point, Point);
+
+/** \fn double lengthCeil2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB CEIL_2D de deux points (euclidienne arrondie à l'entier supérieur)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthCeil2D(Point, Point);
+
+/** \fn double lengthAtt(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB ATT (pseudo-euclidienne) de deux points
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthAtt(Point, Point);
+
+/** \fn double lengthMan2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB MAN_2D de deux points (Manhattan arrondie à l'entier le plus proche)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthMan2D(Point, Point);
+
+/** \fn double lengthMax2D(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB MAX_2D de deux points (plus grand écart arrondi à l'entier le plus proche)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthMax2D(Point, Point);
+
+/** \fn double lengthGeo(Point p1, Point p2)
+ *  \brief renvoie la distance TSPLIB GEO de deux points (x latitude, y longitude, en km sur la sphère terrestre)
+ * \param p1 Objet de type Point
+ * \param p2 Objet de type Point
+ * \return Distance entière
+ */
+
+double lengthGeo(Point, Point);
+
+/** \fn void lengthEuc2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthEuc2D (voir lengthEucRow)
+ */
+
+void lengthEuc2DRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn void lengthCeil2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthCeil2D (voir lengthEucRow)
+ */
+
+void lengthCeil2DRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn void lengthAttRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthAtt (voir lengthEucRow)
+ */
+
+void lengthAttRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn void lengthMan2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthMan2D (voir lengthEucRow)
+ */
+
+void lengthMan2DRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn void lengthMax2DRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthMax2D (voir lengthEucRow)
+ */
+
+void lengthMax2DRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn void lengthGeoRow(Point p, const double *xs, const double *ys, double *out, int n)
+ *  \brief version ligne par ligne de lengthGeo (voir lengthEucRow)
+ */
+
+void lengthGeoRow(Point, const double *restrict, const double *restrict, double *restrict, int);
+
+/** \fn LengthFct lengthGetFct(int type)
+ *  \brief renvoie la fonction de distance entre deux points spécialisée pour type, à choisir une fois au lieu de tester lengthType à chaque appel
+ * \param type EUCLIDIAN, MANHATTAN ou un type TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D)
+ * \return Fonction de distance
+ */
+
+LengthFct lengthGetFct(int);
+
+/** \fn LengthRowFct lengthGetRowFct(int type)
+ *  \brief renvoie le noyau de distances d'un point vers une ligne de points spécialisé pour type
+ * \param type EUCLIDIAN, MANHATTAN ou un type TSPLIB (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D)
+ * \return Noyau de distances ligne par ligne
+ */
+
+LengthRowFct lengthGetRowFct(int);
 
 /** \fn double pointGetX(Point p)
  *  \brief retourne l'abscisse du Point p
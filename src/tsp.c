@@ -8,12 +8,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #include "string.h"
 #include "point.h"
 #include "city.h"
 #include "map.h"
 #include "tsp.h"
+#include "tspbin.h"
 #include "fcts.h"
 
 /**
@@ -67,30 +69,558 @@ void throwTspWarn(Str msg, int lcount, Str addMsg)
 }
 
 /**
- * \fn void freeBfrs(Str str, double **ews, Point *dds, int nbCities)
- * \brief Fonction qui libère les buffers alloués lors de la lecture d'un fichier corrompu par tspLoad.
- * \param Str str : Chaîne actuellement décodée.
- * \param double **ews : Matrice de distances.
- * \param Point *dds : Tableau des coordonnées des villes.
- * \param int nbCities : Nombre de villes.
+ * \def TSP_CHUNK_SIZE
+ * \brief Taille des blocs lus d'un coup dans le fichier TSP.
+ */
+
+#define TSP_CHUNK_SIZE (1<<20)
+
+/**
+ * \def TSP_TOKEN_MAX
+ * \brief Longueur maximale d'un mot ou d'un nombre : le tampon est rechargé dès qu'il en reste moins devant la position courante.
+ */
+
+#define TSP_TOKEN_MAX 256
+
+/**
+ * \def EWT_NONE
+ * \brief EDGE_WEIGHT_TYPE absent du fichier.
+ */
+
+#define EWT_NONE -1
+
+/**
+ * \def EWT_EXPLICIT
+ * \brief EDGE_WEIGHT_TYPE EXPLICIT : distances données par EDGE_WEIGHT_SECTION.
+ */
+
+#define EWT_EXPLICIT -2
+
+/**
+ * \def EWT_UNSUPPORTED
+ * \brief EDGE_WEIGHT_TYPE non géré (3D, XRAY, SPECIAL...).
+ */
+
+#define EWT_UNSUPPORTED -3
+
+/**
+ * \def EWF_FULL_MATRIX
+ * \brief EDGE_WEIGHT_FORMAT FULL_MATRIX : n lignes de n distances.
+ */
+
+#define EWF_FULL_MATRIX 0
+
+/**
+ * \def EWF_UPPER_ROW
+ * \brief EDGE_WEIGHT_FORMAT UPPER_ROW (ou LOWER_COL) : triangle supérieur sans la diagonale, ligne par ligne.
+ */
+
+#define EWF_UPPER_ROW 1
+
+/**
+ * \def EWF_LOWER_ROW
+ * \brief EDGE_WEIGHT_FORMAT LOWER_ROW (ou UPPER_COL) : triangle inférieur sans la diagonale, ligne par ligne.
+ */
+
+#define EWF_LOWER_ROW 2
+
+/**
+ * \def EWF_UPPER_DIAG_ROW
+ * \brief EDGE_WEIGHT_FORMAT UPPER_DIAG_ROW (ou LOWER_DIAG_COL) : triangle supérieur avec la diagonale.
+ */
+
+#define EWF_UPPER_DIAG_ROW 3
+
+/**
+ * \def EWF_LOWER_DIAG_ROW
+ * \brief EDGE_WEIGHT_FORMAT LOWER_DIAG_ROW (ou UPPER_DIAG_COL) : triangle inférieur avec la diagonale.
+ */
+
+#define EWF_LOWER_DIAG_ROW 4
+
+/**
+ * \def EWF_UNSUPPORTED
+ * \brief EDGE_WEIGHT_FORMAT non géré.
+ */
+
+#define EWF_UNSUPPORTED -1
+
+/**
+ * \struct TspReader
+ * \brief Lecteur par blocs d'un fichier TSP, les mots sont lus directement dans son tampon.
+ */
+
+typedef struct TspReader
+{
+    FILE *file; /*!< Fichier lu. */
+    char *buf; /*!< Tampon de TSP_CHUNK_SIZE octets, toujours terminé par '\0'. */
+    size_t pos; /*!< Position courante dans le tampon. */
+    size_t len; /*!< Nombre d'octets valides dans le tampon. */
+    bool eof; /*!< Vaut true quand le fichier a été lu entièrement. */
+    int line; /*!< Ligne courante (pour les messages d'erreur). */
+} TspReader;
+
+/**
+ * \struct StrView
+ * \brief Vue sur un mot du tampon (non terminée par '\0', valable jusqu'au prochain rechargement).
+ */
+
+typedef struct StrView
+{
+    const char *s; /*!< Début du mot. */
+    int len; /*!< Longueur du mot. */
+} StrView;
+
+/**
+ * \fn static void readerFill(TspReader *r)
+ * \brief Fonction qui recharge le tampon lorsqu'il reste moins de TSP_TOKEN_MAX octets à lire.
+ * \param TspReader *r : Lecteur.
  * \return void
  */
 
-void freeBfrs(Str str, double **ews, Point *dds, int nbCities)
+static void readerFill(TspReader *r)
 {
-    if(str)
-        free(str);
+    if(r->eof || r->len-r->pos>=TSP_TOKEN_MAX)
+        return;
+
+    size_t rest=r->len-r->pos;
+    memmove(r->buf, r->buf+r->pos, rest); // le mot en cours reste entier
+    size_t nb=fread(r->buf+rest, 1, TSP_CHUNK_SIZE-rest, r->file);
+
+    r->pos=0;
+    r->len=rest+nb;
+    r->buf[r->len]='\0';
+
+    if(nb==0)
+        r->eof=true;
+}
 
-    if(ews)
+/**
+ * \fn static char readerPeek(TspReader *r)
+ * \brief Fonction qui retourne le caractère courant sans le consommer ('\0' à la fin du fichier).
+ * \param TspReader *r : Lecteur.
+ * \return Le caractère courant.
+ */
+
+static char readerPeek(TspReader *r)
+{
+    readerFill(r);
+    return r->buf[r->pos];
+}
+
+/**
+ * \fn static void readerSkipBlanks(TspReader *r)
+ * \brief Fonction qui saute les espaces de la ligne courante.
+ * \param TspReader *r : Lecteur.
+ * \return void
+ */
+
+static void readerSkipBlanks(TspReader *r)
+{
+    char c;
+
+    while((c=readerPeek(r))==' ' || c=='\t' || c=='\r')
+        r->pos++;
+}
+
+/**
+ * \fn static void readerSkipSpaces(TspReader *r)
+ * \brief Fonction qui saute les espaces et les fins de ligne.
+ * \param TspReader *r : Lecteur.
+ * \return void
+ */
+
+static void readerSkipSpaces(TspReader *r)
+{
+    char c;
+
+    while(isSpaceChar(c=readerPeek(r)))
     {
-        for(int i=0; i<nbCities; i++)
-            free(ews[i]);
+        if(c=='\n')
+            r->line++;
+        r->pos++;
+    }
+}
+
+/**
+ * \fn static void readerSkipLine(TspReader *r)
+ * \brief Fonction qui passe au début de la ligne suivante.
+ * \param TspReader *r : Lecteur.
+ * \return void
+ */
 
-        free(ews);
+static void readerSkipLine(TspReader *r)
+{
+    char c;
+
+    while((c=readerPeek(r))!='\0' && c!='\n')
+        r->pos++;
+
+    if(c=='\n')
+    {
+        r->line++;
+        r->pos++;
     }
+}
+
+/**
+ * \fn static StrView readerWord(TspReader *r)
+ * \brief Fonction qui lit le mot courant (jusqu'à un séparateur), sans copie.
+ * \param TspReader *r : Lecteur.
+ * \return Vue sur le mot (de longueur nulle si la ligne est vide).
+ */
+
+static StrView readerWord(TspReader *r)
+{
+    readerFill(r);
+
+    StrView w;
+    w.s=r->buf+r->pos;
+    w.len=0;
 
-    if(dds)
-        free(dds);
+    while(w.len<TSP_TOKEN_MAX && !isEOS(w.s[w.len]) && !isSepChar(w.s[w.len]))
+        w.len++;
+
+    r->pos+=w.len;
+
+    return w;
+}
+
+/**
+ * \fn static bool viewEquals(StrView w, Str str)
+ * \brief Fonction qui compare un mot lu à une chaîne.
+ * \param StrView w : Mot lu.
+ * \param Str str : Chaîne de comparaison.
+ * \return true si le mot est égal à la chaîne.
+ */
+
+static bool viewEquals(StrView w, Str str)
+{
+    return strLength(str)==w.len && strncmp(w.s, str, w.len)==0;
+}
+
+/**
+ * \fn static void readerRestOfLine(TspReader *r, char *dst, int size)
+ * \brief Fonction qui copie la fin de la ligne courante (tronquée à size-1 caractères) pour un message, et passe à la ligne suivante.
+ * \param TspReader *r : Lecteur.
+ * \param char *dst : Destination.
+ * \param int size : Taille de la destination.
+ * \return void
+ */
+
+static void readerRestOfLine(TspReader *r, char *dst, int size)
+{
+    int i=0;
+    char c;
+
+    while((c=readerPeek(r))!='\0' && !isEOL(c))
+    {
+        if(i<size-1)
+            dst[i++]=c;
+        r->pos++;
+    }
+    dst[i]='\0';
+
+    readerSkipLine(r);
+}
+
+/**
+ * \fn static bool readerNumber(TspReader *r, double *val)
+ * \brief Fonction qui lit le prochain nombre (éventuellement sur une autre ligne).
+ * \param TspReader *r : Lecteur.
+ * \param double *val : Valeur lue.
+ * \return false si le prochain mot n'est pas un nombre suivi d'un espace.
+ *
+ * Les nombres d'au plus 15 chiffres significatifs dont l'exposant décimal est petit sont convertis exactement
+ * par une seule multiplication ou division (arrondi correct, comme atof), les autres sont confiés à strtod.
+ */
+
+static bool readerNumber(TspReader *r, double *val)
+{
+    static const double pow10[]={1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    readerSkipSpaces(r);
+    readerFill(r);
+
+    const char *start=r->buf+r->pos, *p=start;
+    bool neg=false;
+    bool digits=false;
+    uint64_t mant=0;
+    int nbDigits=0; // chiffres significatifs gardés dans mant
+    int exp10=0;
+
+    if(*p=='-' || *p=='+')
+        neg=*p++=='-';
+
+    for(; *p>='0' && *p<='9'; p++)
+    {
+        digits=true;
+        if(nbDigits<19)
+        {
+            mant=mant*10+(*p-'0');
+            nbDigits+=mant>0;
+        }
+        else
+            exp10++;
+    }
+
+    if(*p=='.')
+        for(p++; *p>='0' && *p<='9'; p++)
+        {
+            digits=true;
+            if(nbDigits<19)
+            {
+                mant=mant*10+(*p-'0');
+                nbDigits+=mant>0;
+                exp10--;
+            }
+        }
+
+    if(!digits)
+        return false;
+
+    if(*p=='e' || *p=='E')
+    {
+        const char *q=p+1;
+        bool expNeg=false;
+        int e=0;
+
+        if(*q=='-' || *q=='+')
+            expNeg=*q++=='-';
+
+        if(*q>='0' && *q<='9')
+        {
+            for(; *q>='0' && *q<='9'; q++)
+                if(e<10000)
+                    e=e*10+(*q-'0');
+
+            exp10+=expNeg ? -e : e;
+            p=q;
+        }
+    }
+
+    if(!isEOS(*p) && !isSpaceChar(*p))
+        return false;
+
+    if(nbDigits<=15 && exp10>=-22 && exp10<=22) // mant et 10^|exp10| exacts en double : un seul arrondi
+        *val=exp10<0 ? mant/pow10[-exp10] : mant*pow10[exp10];
+    else
+        *val=strtod(neg ? start+1 : start, NULL);
+
+    if(neg)
+        *val=-*val;
+
+    r->pos+=p-start;
+
+    return true;
+}
+
+/**
+ * \fn static bool readerValue(TspReader *r, StrView *v)
+ * \brief Fonction qui lit la valeur d'une ligne d'en-tête "MOT_CLE : VALEUR".
+ * \param TspReader *r : Lecteur (placé après le mot clé).
+ * \param StrView *v : Valeur lue.
+ * \return false s'il manque ':'.
+ */
+
+static bool readerValue(TspReader *r, StrView *v)
+{
+    readerSkipBlanks(r);
+
+    if(readerPeek(r)!=':')
+        return false;
+
+    r->pos++;
+    readerSkipBlanks(r);
+
+    *v=readerWord(r);
+
+    return true;
+}
+
+/**
+ * \fn static int tspEdgeWeightType(StrView v)
+ * \brief Fonction qui traduit la valeur de EDGE_WEIGHT_TYPE en type de longueur (voir point.h).
+ * \param StrView v : Valeur lue.
+ * \return Le type de longueur, EWT_EXPLICIT ou EWT_UNSUPPORTED.
+ */
+
+static int tspEdgeWeightType(StrView v)
+{
+    if(viewEquals(v, "EXPLICIT"))
+        return EWT_EXPLICIT;
+    if(viewEquals(v, "EUC_2D"))
+        return EUC_2D;
+    if(viewEquals(v, "CEIL_2D"))
+        return CEIL_2D;
+    if(viewEquals(v, "GEO"))
+        return GEO;
+    if(viewEquals(v, "ATT"))
+        return ATT;
+    if(viewEquals(v, "MAN_2D"))
+        return MAN_2D;
+    if(viewEquals(v, "MAX_2D"))
+        return MAX_2D;
+    return EWT_UNSUPPORTED;
+}
+
+/**
+ * \fn static int tspEdgeWeightFormat(StrView v)
+ * \brief Fonction qui traduit la valeur de EDGE_WEIGHT_FORMAT.
+ * \param StrView v : Valeur lue.
+ * \return Le format (les formats par colonnes sont ramenés au format par lignes équivalent, la matrice étant symétrique), ou EWF_UNSUPPORTED.
+ */
+
+static int tspEdgeWeightFormat(StrView v)
+{
+    if(viewEquals(v, "FULL_MATRIX"))
+        return EWF_FULL_MATRIX;
+    if(viewEquals(v, "UPPER_ROW") || viewEquals(v, "LOWER_COL"))
+        return EWF_UPPER_ROW;
+    if(viewEquals(v, "LOWER_ROW") || viewEquals(v, "UPPER_COL"))
+        return EWF_LOWER_ROW;
+    if(viewEquals(v, "UPPER_DIAG_ROW") || viewEquals(v, "LOWER_DIAG_COL"))
+        return EWF_UPPER_DIAG_ROW;
+    if(viewEquals(v, "LOWER_DIAG_ROW") || viewEquals(v, "UPPER_DIAG_COL"))
+        return EWF_LOWER_DIAG_ROW;
+    return EWF_UNSUPPORTED;
+}
+
+/**
+ * \fn static bool tspReadWeights(TspReader *r, Map m, int nbCities, int format)
+ * \brief Fonction qui lit un EDGE_WEIGHT_SECTION directement dans la matrice de la Map.
+ * \param TspReader *r : Lecteur.
+ * \param Map m : Map dont la matrice (triangle) est allouée.
+ * \param int nbCities : Nombre de villes.
+ * \param int format : Format des distances (EWF_...).
+ * \return false si des données manquent.
+ *
+ * Les formats triangulaires sont symétriques par définition ; une FULL_MATRIX non symétrique fait passer la matrice en stockage complet.
+ */
+
+static bool tspReadWeights(TspReader *r, Map m, int nbCities, int format)
+{
+    double val;
+
+    for(int i=0; i<nbCities; i++)
+    {
+        int jBegin=0, jEnd=nbCities; // colonnes [jBegin, jEnd[ de la ligne i présentes dans le fichier
+
+        switch(format)
+        {
+        case EWF_UPPER_ROW:
+            jBegin=i+1;
+            break;
+        case EWF_LOWER_ROW:
+            jEnd=i;
+            break;
+        case EWF_UPPER_DIAG_ROW:
+            jBegin=i;
+            break;
+        case EWF_LOWER_DIAG_ROW:
+            jEnd=i+1;
+            break;
+        }
+
+        for(int j=jBegin; j<jEnd; j++)
+        {
+            if(!readerNumber(r, &val))
+            {
+                if(readerPeek(r)=='\0')
+                    throwTspWarn("Data missing in EDGE_WEIGHT_SECTION", r->line, NULL);
+                else
+                    throwTspWarn("Expected number", r->line, NULL);
+                return false;
+            }
+
+            if(format==EWF_FULL_MATRIX && j<i && mapGetDistsLayout(m)==DISTS_TRIANGLE && val!=mapDist(m, i, j))
+                mapUnpackDists(m); // matrice non symétrique, on repasse en stockage complet
+
+            mapSetDist(m, i, j, val);
+        }
+
+        if(format==EWF_UPPER_ROW || format==EWF_LOWER_ROW) // diagonale absente du fichier
+            mapSetDist(m, i, i, 0);
+    }
+
+    return true;
+}
+
+/**
+ * \fn static bool tspReadCoords(TspReader *r, Point *pts, int nbCities, Str section)
+ * \brief Fonction qui lit un NODE_COORD_SECTION ou un DISPLAY_DATA_SECTION (lignes "indice x y").
+ * \param TspReader *r : Lecteur.
+ * \param Point *pts : Tableau des coordonnées à remplir.
+ * \param int nbCities : Nombre de villes.
+ * \param Str section : Nom de la section (pour les messages).
+ * \return false si des données manquent ou sont invalides.
+ */
+
+static bool tspReadCoords(TspReader *r, Point *pts, int nbCities, Str section)
+{
+    char msg[100];
+    double val;
+    int cIndex=-1;
+
+    for(int i=0; i<nbCities; i++)
+    {
+        for(int j=0; j<3; j++)
+        {
+            if(!readerNumber(r, &val))
+            {
+                if(readerPeek(r)=='\0')
+                {
+                    sprintf(msg, "Data missing in %s", section);
+                    throwTspWarn(msg, r->line, NULL);
+                }
+                else
+                    throwTspWarn("Expected number", r->line, NULL);
+                return false;
+            }
+
+            if(j==0)
+            {
+                cIndex=(int)val-1;
+
+                if(cIndex<0 || cIndex>=nbCities)
+                {
+                    throwTspWarn("Invalid index for city", r->line, NULL);
+                    return false;
+                }
+            }
+            else if(j==1)
+                pts[cIndex].x=val;
+            else
+                pts[cIndex].y=val;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \fn static void freeBfrs(TspReader *r, Map m, Point *ncs, Point *dds)
+ * \brief Fonction qui libère les buffers alloués lors de la lecture d'un fichier corrompu par tspLoad.
+ * \param TspReader *r : Lecteur (fichier et tampon).
+ * \param Map m : Map en cours de remplissage (matrice de distances).
+ * \param Point *ncs : Tableau des coordonnées des villes (NODE_COORD_SECTION).
+ * \param Point *dds : Tableau des positions d'affichage des villes (DISPLAY_DATA_SECTION).
+ * \return void
+ */
+
+static void freeBfrs(TspReader *r, Map m, Point *ncs, Point *dds)
+{
+    if(r->file)
+        fclose(r->file);
+
+    free(r->buf);
+
+    if(m)
+        mapDeleteRec(m);
+
+    free(ncs);
+    free(dds);
 }
 
 /**
@@ -98,340 +628,350 @@ void freeBfrs(Str str, double **ews, Point *dds, int nbCities)
  * \brief Fonction qui lit un fichier TSP et qui retourne une Map.
  * \param Str filename : Chaîne de caractères contenant le chemin du fichier à lire.
  * \return La Map à laquelle on appliquera les algorithmes.
+ *
+ * Le fichier est lu par blocs de TSP_CHUNK_SIZE octets, les mots clés sont comparés dans le tampon et les nombres
+ * convertis sans allocation : la taille des lignes n'est pas limitée.
+ * Les caches binaires écrits par tspBinWrite sont reconnus à leur signature et ouverts par tspBinLoad.
+ * Les matrices (FULL_MATRIX et formats triangulaires) sont lues directement dans la matrice de la Map ; les instances
+ * NODE_COORD_SECTION (EUC_2D, CEIL_2D, GEO, ATT, MAN_2D, MAX_2D) sont construites par mapLoadPoints avec l'arrondi TSPLIB,
+ * en distances entières (ou à la demande pour les grandes instances).
  */
 
 Map tspLoad(Str filename)
 {
-    char line[102400];
-    int index, index2, indext1, indext2;
-    int lcount=1;
+    char line[TSP_TOKEN_MAX];
+    int lcount;
 
     bool dimok=false;
     bool ewsok=false;
+    bool ncsok=false;
     bool ddsok=false;
     bool eofok=false;
 
     int nbCities=-1;
-    int cIndex=-1;
-
-    Str str=NULL, str2=NULL;
-
-    FILE *file = fopen(filename, "r");
+    int ewType=EWT_NONE;
+    int ewFormat=EWF_FULL_MATRIX;
+    double val;
+    StrView v;
+
+    if(tspBinIsFile(filename))
+        return tspBinLoad(filename);
+
+    TspReader r;
+    r.file=fopen(filename, "rb");
+    r.buf=NULL;
+    r.pos=0;
+    r.len=0;
+    r.eof=false;
+    r.line=1;
 
     Point pNULL;
     pNULL.x=0;
     pNULL.y=0;
 
-    double **ews=NULL;
+    Map m=NULL;
+    Point *ncs=NULL;
     Point *dds=NULL;
 
-    if(!file)
+    if(!r.file)
     {
         throwTspWarn("File could'nt be loaded from", 0, filename);
-        //free(dds);
         return NULL;
     }
 
+    r.buf=malloc(TSP_CHUNK_SIZE+1);
+    r.buf[0]='\0';
+
     throwMsg("TSP Reader", filename);
 
-    while(fgets(line, sizeof(line), file) != NULL)
+    while(readerPeek(&r)!='\0')
     {
+        readerSkipBlanks(&r);
 
-        index=0;
-
-        while(!isEOL(line[index]) && isSpaceChar(line[index])) // Recherche debut mot
-            index++;
+        lcount=r.line;
 
-        index2=index;
+        StrView str=readerWord(&r);
 
-        while(!isEOL(line[index2]) && !isSepChar(line[index2])) // Recherche fin mot
-            index2++;
+        if(viewEquals(str, "NAME") || viewEquals(str, "COMMENT") || viewEquals(str, "DISPLAY_DATA_TYPE"))
+            readerSkipLine(&r);
+        else if(viewEquals(str, "TYPE"))
+        {
+            if(!readerValue(&r, &v))
+            {
+                throwTspWarn("Expected ':'", lcount, NULL);
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
 
-        str=subString(line, index, index2);
+            if(!viewEquals(v, "TSP") && !viewEquals(v, "ATSP"))
+                throwTspWarn("Only TSP and ATSP files are supported", lcount, NULL);
 
-        /*if(strCmp(str, "NAME"))
-        {
-            //printf("NAME l%d\n", lcount);
-        }
-        else if(strCmp(str, "TYPE"))
-        {
-            //printf("NAME l%d\n", lcount);
+            readerSkipLine(&r);
         }
-        else if(strCmp(str, "COMMENT"))
-        {
-            //printf("NAME l%d\n", lcount);
-        }*/
-        if(strCmp(str, "DIMENSION"))
+        else if(viewEquals(str, "DIMENSION"))
         {
             dimok=true;
-            indext1=index2;
 
-            while(!isEOL(line[indext1]) && isSpaceChar(line[indext1]))
-                indext1++;
+            readerSkipBlanks(&r);
 
-            if(line[indext1]!=':')
+            if(readerPeek(&r)!=':')
             {
                 throwTspWarn("Expected ':'", lcount, NULL);
-                freeBfrs(str, ews, dds, nbCities);
+                freeBfrs(&r, m, ncs, dds);
                 return NULL;
             }
 
-            indext1++;
-
-            while(!isEOL(line[indext1]) && isSpaceChar(line[indext1]))
-                indext1++;
-
-            indext2=indext1;
+            r.pos++;
+            readerSkipBlanks(&r);
 
-            if(!isNumber(line[indext2]))
+            if(isEOL(readerPeek(&r)) || !readerNumber(&r, &val) || val!=(int)val)
             {
                 throwTspWarn("Expected number", lcount, NULL);
-                freeBfrs(str, ews, dds, nbCities);
+                freeBfrs(&r, m, ncs, dds);
                 return NULL;
             }
 
-            while(!isEOL(line[indext2]) && isNumber(line[indext2]))
-                indext2++;
-
-            str2=subString(line, indext1, indext2);
-
-            nbCities=atoi(str2);
+            nbCities=(int)val;
 
             if(nbCities<0)
             {
                 throwTspWarn("Amount of cities isn't acceptable", lcount, NULL);
-                freeBfrs(str, ews, dds, nbCities);
-                free(str2);
+                freeBfrs(&r, m, ncs, dds);
                 return NULL;
             }
 
-            free(str2);
+            free(ncs);
+            free(dds);
+            ncs=malloc(nbCities*sizeof(Point));
+            dds=malloc(nbCities*sizeof(Point));
 
-            ews=malloc(nbCities*sizeof(double*));
+            readerSkipLine(&r);
+        }
+        else if(viewEquals(str, "EDGE_WEIGHT_TYPE"))
+        {
+            if(!readerValue(&r, &v))
+            {
+                throwTspWarn("Expected ':'", lcount, NULL);
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
 
-            for(int i=0; i<nbCities; i++)
-                ews[i]=malloc(nbCities*sizeof(double));
+            ewType=tspEdgeWeightType(v);
 
-            dds=malloc(nbCities*sizeof(Point));
+            if(ewType==EWT_UNSUPPORTED)
+            {
+                throwTspWarn("Unsupported EDGE_WEIGHT_TYPE", lcount, NULL);
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
+
+            readerSkipLine(&r);
         }
-        else if(strCmp(str, "EDGE_WEIGHT_SECTION"))
+        else if(viewEquals(str, "EDGE_WEIGHT_FORMAT"))
         {
-            ewsok=true;
-            if(nbCities<0)
+            if(!readerValue(&r, &v))
             {
-                throwTspWarn("Expected DIMENSION parameter before", lcount, NULL);
-                freeBfrs(str, ews, dds, nbCities);
+                throwTspWarn("Expected ':'", lcount, NULL);
+                freeBfrs(&r, m, ncs, dds);
                 return NULL;
             }
 
-            lcount++;
-
-            for(int i=0; i<nbCities; i++)
+            if(!viewEquals(v, "FUNCTION")) // FUNCTION : distances calculées d'après EDGE_WEIGHT_TYPE
             {
-                if(fgets(line, sizeof(line), file)==NULL)
+                ewFormat=tspEdgeWeightFormat(v);
+
+                if(ewFormat==EWF_UNSUPPORTED)
                 {
-                    throwTspWarn("Data missing in EDGE_WEIGHT_SECTION", lcount, NULL);
-                    freeBfrs(str, ews, dds, nbCities);
+                    throwTspWarn("Unsupported EDGE_WEIGHT_FORMAT", lcount, NULL);
+                    freeBfrs(&r, m, ncs, dds);
                     return NULL;
                 }
+            }
 
-                index=0;
+            readerSkipLine(&r);
+        }
+        else if(viewEquals(str, "NODE_COORD_TYPE"))
+        {
+            if(readerValue(&r, &v) && viewEquals(v, "THREED_COORDS"))
+            {
+                throwTspWarn("3D coordinates are not supported", lcount, NULL);
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
 
-                for(int j=0; j<nbCities; j++)
-                {
-                    while(!isEOL(line[index]) && isSpaceChar(line[index]))
-                        index++;
+            readerSkipLine(&r);
+        }
+        else if(viewEquals(str, "EDGE_WEIGHT_SECTION"))
+        {
+            ewsok=true;
+            if(nbCities<0)
+            {
+                throwTspWarn("Expected DIMENSION parameter before", lcount, NULL);
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
 
-                    if(isEOL(line[index]))
-                    {
-                        throwTspWarn("Data missing in EDGE_WEIGHT_SECTION", lcount, NULL);
-                        freeBfrs(str, ews, dds, nbCities);
-                        return NULL;
-                    }
+            if(m)
+            {
+                throwTspWarn("EDGE_WEIGHT_SECTION already read", lcount, NULL);
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
 
-                    index2=index;
+            m=mapCreate();
+            mapSetName(m, filename);
 
-                    if(!isNumber(line[index2]))
-                    {
-                        throwTspWarn("Expected number", lcount, NULL);
-                        freeBfrs(str, ews, dds, nbCities);
-                        return NULL;
-                    }
+            bool q16=mapGetDistsType(m)==DISTS_Q16; // le pas de quantification dépend de la plus grande distance, pas encore lue
 
-                    while(!isEOL(line[index2]) && isNumber(line[index2]))
-                        index2++;
+            if(q16)
+                mapSetDistsType(m, DISTS_FLOAT);
 
-                    if(!isSpaceChar(line[index2]))
-                    {
-                        throwTspWarn("Expected ' '", lcount, NULL);
-                        freeBfrs(str, ews, dds, nbCities);
-                        return NULL;
-                    }
+            mapAllocDists(m, nbCities, DISTS_TRIANGLE); // les distances sont lues directement dans la matrice de la Map, supposée symétrique
 
-                    line[index2]='\0';
+            readerSkipLine(&r);
 
-                    ews[i][j]=Atof(line+index);
+            if(!tspReadWeights(&r, m, nbCities, ewFormat))
+            {
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
 
-                    index=index2+1;
-                }
+            if(q16)
+                mapConvertDists(m, DISTS_Q16);
 
-                lcount++;
-            }
-            lcount--;
+            readerSkipLine(&r);
         }
-        else if(strCmp(str, "DISPLAY_DATA_SECTION"))
+        else if(viewEquals(str, "NODE_COORD_SECTION") || viewEquals(str, "DISPLAY_DATA_SECTION"))
         {
-            ddsok=true;
+            bool ncsSection=viewEquals(str, "NODE_COORD_SECTION");
+
             if(nbCities<0)
             {
                 throwTspWarn("Expected DIMENSION parameter before", lcount, NULL);
-                freeBfrs(str, ews, dds, nbCities);
+                freeBfrs(&r, m, ncs, dds);
                 return NULL;
             }
 
-            lcount++;
+            readerSkipLine(&r);
 
-            for(int i=0; i<nbCities; i++)
+            if(!tspReadCoords(&r, ncsSection ? ncs : dds, nbCities, ncsSection ? "NODE_COORD_SECTION" : "DISPLAY_DATA_SECTION"))
             {
-                if(fgets(line, sizeof(line), file)==NULL)
-                {
-                    throwTspWarn("Data missing in DISPLAY_DATA_SECTION", lcount, NULL);
-                    freeBfrs(str, ews, dds, nbCities);
-                    return NULL;
-                }
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
 
-                index=0;
+            if(ncsSection)
+                ncsok=true;
+            else
+                ddsok=true;
 
-                for(int j=0; j<3; j++)
-                {
-                    while(!isEOL(line[index]) && isSpaceChar(line[index]))
-                        index++;
-
-                    if(isEOL(line[index]))
-                    {
-                        throwTspWarn("Data missing in DISPLAY_DATA_SECTION", lcount, NULL);
-                        freeBfrs(str, ews, dds, nbCities);
-                        return NULL;
-                    }
-
-                    index2=index;
-
-                    if(!isNumber(line[index2]))
-                    {
-                        throwTspWarn("Expected number", lcount, NULL);
-                        freeBfrs(str, ews, dds, nbCities);
-                        return NULL;
-                    }
-
-                    while(!isEOL(line[index2]) && isNumber(line[index2]))
-                        index2++;
-
-                    if(!isSpaceChar(line[index2]))
-                    {
-                        throwTspErr("Expected ' '", lcount, NULL);
-                        freeBfrs(str, ews, dds, nbCities);
-                        return NULL;
-                    }
-
-                    line[index2]='\0';
-
-                    if(j==0)
-                    {
-                        cIndex=atoi(line+index);
-                        cIndex--;
-
-                        if(cIndex<0 || cIndex>=nbCities)
-                        {
-                            throwTspWarn("Invalid index for city", lcount, NULL);
-                            freeBfrs(str, ews, dds, nbCities);
-                            return NULL;
-                        }
-
-                        index=index2+1;
-                    }
-                    else if(j==1)
-                    {
-                        dds[cIndex].x=Atof(line+index);
-
-                        index=index2+1;
-                    }
-                    else
-                    {
-                        dds[cIndex].y=Atof(line+index);
-                    }
-                }
-                lcount++;
-            }
-            lcount--;
+            readerSkipLine(&r);
         }
-        else if(strCmp(str, "EOF"))
+        else if(viewEquals(str, "FIXED_EDGES_SECTION") || viewEquals(str, "TOUR_SECTION") || viewEquals(str, "DEPOT_SECTION"))
+        {
+            throwTspWarn("Section ignored", lcount, NULL);
+
+            readerSkipLine(&r);
+
+            while(readerNumber(&r, &val) && val!=-1) // ces sections se terminent par -1
+                ;
+
+            readerSkipLine(&r);
+        }
+        else if(viewEquals(str, "EOF"))
         {
             eofok=true;
-            free(str);
-            str=NULL;
             break;
         }
-        else if(strCmp(str, "")) {}
+        else if(str.len==0 && isEOL(readerPeek(&r)))
+            readerSkipLine(&r);
         else
         {
-            strSetLength(line, strLength(line)-1);
+            int len=str.len<TSP_TOKEN_MAX-1 ? str.len : TSP_TOKEN_MAX-1;
+            strncpy(line, str.s, len);
+            readerRestOfLine(&r, line+len, TSP_TOKEN_MAX-len);
             throwTspWarn("Unknown instruction", lcount, line);
         }
-
-        free(str);
-        str=NULL;
-
-        lcount++;
     }
 
-    fclose(file);
+    lcount=r.line;
 
-    Map m;
+    fclose(r.file);
+    r.file=NULL;
+    free(r.buf);
+    r.buf=NULL;
 
     if(!dimok)
     {
         throwTspWarn("Expected instruction DIMENSION", lcount, NULL);
         return NULL;
     }
-    if(!ewsok)
+
+    Point *pos=ddsok ? dds : (ncsok ? ncs : NULL); // positions affichées des villes
+
+    if(ewType>=0) // distances calculées d'après les coordonnées
+    {
+        if(!ncsok)
+        {
+            throwTspWarn("Expected instruction NODE_COORD_SECTION", lcount, NULL);
+
+            if(!ddsok)
+            {
+                freeBfrs(&r, m, ncs, dds);
+                return NULL;
+            }
+
+            memcpy(ncs, dds, nbCities*sizeof(Point));
+        }
+
+        if(m)
+        {
+            throwTspWarn("EDGE_WEIGHT_SECTION ignored, distances are computed from coordinates", lcount, NULL);
+            mapDeleteRec(m);
+        }
+
+        m=mapCreate();
+        mapSetName(m, filename);
+        mapSetLengthType(m, ewType);
+
+        if(mapGetDistsType(m)==DISTS_DOUBLE)
+            mapSetDistsType(m, DISTS_INT); // les distances TSPLIB sont entières : stockage exact sur 32 bits
+
+        mapLoadPoints(m, ncs, nbCities);
+    }
+    else if(!ewsok)
     {
-        if(ddsok)
+        if(pos)
         {
             throwTspWarn("Expected instruction EDGE_WEIGHT_SECTION", lcount, NULL);
-            m=mapCreateFromPoints(dds, nbCities, filename);
+            m=mapCreateFromPoints(pos, nbCities, filename);
         }
         else
         {
             throwTspWarn("Expected instruction EDGE_WEIGHT_SECTION", lcount, NULL);
-            freeBfrs(str, ews, dds, nbCities);
+            freeBfrs(&r, m, ncs, dds);
             return NULL;
         }
     }
     else
     {
-        m=mapCreate();
-        mapSetName(m, filename);
-
-        if(ddsok)
+        if(pos)
         {
             for(int i=0; i<nbCities; i++)
-                mapAddCity(m, cityCreate(true, dds[i], ews[i], nbCities));
+                mapAddCity(m, cityCreate(true, pos[i]));
         }
         else
         {
             throwMsg("TSP Reader", "No city positions available");
 
             for(int i=0; i<nbCities; i++)
-                mapAddCity(m, cityCreate(false, pNULL, ews[i], nbCities));
+                mapAddCity(m, cityCreate(false, pNULL));
         }
     }
     if(!eofok)
         throwTspWarn("Expected instruction EOF", lcount, NULL);
 
-    for(int i=0; i<nbCities; i++)
-        free(ews[i]);
-
-    free(ews);
+    free(ncs);
     free(dds);
 
     return m;
@@ -469,7 +1009,7 @@ void tspWrite(Map m, Str filename)
     {
         for(int j=0; j<mapSize; j++)
         {
-            fprintf(file, "%f ", cityGetDist(mapGetCity(m, i), j));
+            fprintf(file, "%f ", mapDist(m, i, j));
         }
         fprintf(file, "\n");
     }
@@ -34,18 +34,6 @@ void throwTspErr(Str, int, Str);
 
 void throwTspWarn(Str, int, Str);
 
- /**
- * \fn void freeBfrs(Str, double**, Point*, int)
- * \brief Fonction qui libère les buffers alloués lors de la lecture d'un fichier corrompu par tspLoad.
- * \param Str : Chaîne actuellement décodée.
- * \param double** : Matrice de distances.
- * \param Point* : Tableau des coordonnées des villes.
- * \param int : Nombre de villes.
- * \return void
- */
- 
-void freeBfrs(Str, double** , Point*, int);
-
 /**
  * \fn Map tspLoad(Str)
  * \brief Fonction qui lit un fichier TSP et qui retourne une Map.
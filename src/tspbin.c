@@ -0,0 +1,316 @@
+/**
+ * \file tspbin.c
+ * \brief Fichier d'implémentation du cache binaire des Map.
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ *
+ * Un cache binaire contient tout ce que tspLoad calcule à partir d'un fichier TSP : en-tête, coordonnées, matrice de
+ * distances dans son format de stockage et, en option, les listes de plus proches voisins. Chaque section est alignée
+ * sur une page : le fichier est projeté en mémoire (fileMap) et la Map pointe directement dans ses pages, rien n'est
+ * relu ni copié. Le format suit l'ordre des octets et la taille des types de la machine qui l'a écrit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "string.h"
+#include "point.h"
+#include "city.h"
+#include "map.h"
+#include "tspbin.h"
+#include "fcts.h"
+
+/**
+ * \def TSPBIN_MAGIC
+ * \brief Signature des caches binaires (8 octets avec le '\\0').
+ */
+
+#define TSPBIN_MAGIC "VDC-MAP"
+
+/**
+ * \def TSPBIN_VERSION
+ * \brief Version du format, à incrémenter à chaque changement de l'en-tête ou des sections.
+ */
+
+#define TSPBIN_VERSION 1
+
+/**
+ * \def TSPBIN_ENDIAN
+ * \brief Valeur témoin de l'ordre des octets de la machine qui a écrit le fichier.
+ */
+
+#define TSPBIN_ENDIAN 0x01020304
+
+/**
+ * \def TSPBIN_ALIGN
+ * \brief Alignement des sections dans le fichier (une page, donc aussi une ligne de cache une fois projeté).
+ */
+
+#define TSPBIN_ALIGN 4096
+
+/**
+ * \struct TspBinHeader
+ * \brief En-tête d'un cache binaire, au début du fichier.
+ */
+
+typedef struct
+{
+    char magic[8]; /*!< TSPBIN_MAGIC. */
+    uint32_t version; /*!< TSPBIN_VERSION. */
+    uint32_t endian; /*!< TSPBIN_ENDIAN. */
+    int32_t nbCities; /*!< Nombre de villes. */
+    int32_t isPos; /*!< 1 si les villes ont des positions (section des coordonnées présente). */
+    int32_t lengthType; /*!< Distance entre les points (voir point.h). */
+    int32_t distsLayout; /*!< DISTS_FULL, DISTS_TRIANGLE ou DISTS_LAZY (pas de section de distances). */
+    int32_t distsType; /*!< Précision des distances stockées. */
+    int32_t nbNeighbours; /*!< Nombre de voisins par ville (0 : pas de section de voisins). */
+    double distsScale; /*!< Pas de quantification DISTS_Q16. */
+    uint64_t coordsOffset; /*!< Position des abscisses puis des ordonnées (nbCities double chacune), 0 si absentes. */
+    uint64_t distsOffset; /*!< Position du bloc de distances, 0 si absent. */
+    uint64_t distsBytes; /*!< Taille du bloc de distances. */
+    uint64_t neighboursOffset; /*!< Position des listes de voisins (nbCities*nbNeighbours int32), 0 si absentes. */
+} TspBinHeader;
+
+/**
+ * \fn static uint64_t tspBinAlign(uint64_t pos)
+ * \brief Fonction qui arrondit une position au début de section suivant.
+ * \param uint64_t pos : Position dans le fichier.
+ * \return La première position alignée sur TSPBIN_ALIGN à partir de pos.
+ */
+
+static uint64_t tspBinAlign(uint64_t pos)
+{
+    return (pos+TSPBIN_ALIGN-1)/TSPBIN_ALIGN*TSPBIN_ALIGN;
+}
+
+/**
+ * \fn static void tspBinPad(FILE *file, uint64_t *pos, uint64_t offset)
+ * \brief Fonction qui complète le fichier par des zéros jusqu'au début d'une section.
+ * \param FILE *file : Fichier en cours d'écriture.
+ * \param uint64_t *pos : Position courante, mise à jour.
+ * \param uint64_t offset : Début de la section.
+ * \return void
+ */
+
+static void tspBinPad(FILE *file, uint64_t *pos, uint64_t offset)
+{
+    for(; *pos<offset; (*pos)++)
+        fputc(0, file);
+}
+
+/**
+ * \fn bool tspBinIsFile(Str filename)
+ * \brief Fonction qui indique si un fichier est un cache binaire (d'après sa signature).
+ * \param Str filename : Chemin du fichier.
+ * \return true si le fichier commence par la signature du cache binaire.
+ */
+
+bool tspBinIsFile(Str filename)
+{
+    char magic[sizeof(TSPBIN_MAGIC)];
+    FILE *file=fopen(filename, "rb");
+
+    if(!file)
+        return false;
+
+    bool res=fread(magic, 1, sizeof(magic), file)==sizeof(magic) && memcmp(magic, TSPBIN_MAGIC, sizeof(magic))==0;
+
+    fclose(file);
+
+    return res;
+}
+
+/**
+ * \fn Map tspBinLoad(Str filename)
+ * \brief Fonction qui ouvre un cache binaire et retourne la Map correspondante, sans copier la matrice.
+ * \param Str filename : Chemin du fichier.
+ * \return La Map, ou NULL si le fichier est invalide.
+ *
+ * La Map garde le fichier projeté (mapAttachMapping) : ses distances, coordonnées et voisins sont lus dans les pages du fichier.
+ */
+
+Map tspBinLoad(Str filename)
+{
+    size_t size;
+    char *data=fileMap(filename, &size);
+
+    throwMsg("TSP Binary Reader", filename);
+
+    if(!data)
+    {
+        throwWarn("TSP Binary Reader", "File could'nt be loaded from", filename);
+        return NULL;
+    }
+
+    TspBinHeader h;
+    Str err=NULL;
+
+    if(size<sizeof(h))
+        err="Truncated header";
+    else
+    {
+        memcpy(&h, data, sizeof(h));
+
+        uint64_t n=h.nbCities>0 ? (uint64_t)h.nbCities : 0;
+
+        if(memcmp(h.magic, TSPBIN_MAGIC, sizeof(h.magic))!=0)
+            err="Not a binary map file";
+        else if(h.version!=TSPBIN_VERSION)
+            err="Unsupported binary map version";
+        else if(h.endian!=TSPBIN_ENDIAN)
+            err="Binary map written with another byte order";
+        else if(h.nbCities<0 || h.nbNeighbours<0 || h.distsLayout<DISTS_FULL || h.distsLayout>DISTS_LAZY || h.distsType<DISTS_DOUBLE || h.distsType>DISTS_Q16)
+            err="Invalid header";
+        else if((h.isPos || h.distsLayout==DISTS_LAZY) && (!h.coordsOffset || h.coordsOffset+2*n*sizeof(double)>size))
+            err="Coordinates missing";
+        else if(h.distsLayout!=DISTS_LAZY && (!h.distsOffset || h.distsOffset+h.distsBytes>size))
+            err="Distances missing";
+        else if(h.nbNeighbours>0 && (!h.neighboursOffset || h.neighboursOffset+n*h.nbNeighbours*sizeof(int32_t)>size))
+            err="Neighbour lists missing";
+    }
+
+    if(err)
+    {
+        throwWarn("TSP Binary Reader", err, filename);
+        fileUnmap(data, size);
+        return NULL;
+    }
+
+    int n=h.nbCities;
+    double *xs=h.coordsOffset ? (double*)(data+h.coordsOffset) : NULL;
+    double *ys=xs ? xs+n : NULL;
+
+    Map m=mapCreate();
+    mapSetName(m, filename);
+    mapSetLengthType(m, h.lengthType);
+    mapSetDistsType(m, h.distsType);
+    mapAttachMapping(m, data, size);
+
+    if(h.distsLayout==DISTS_LAZY)
+        mapUseCoords(m, xs, ys, n);
+    else
+    {
+        mapUseDists(m, data+h.distsOffset, n, h.distsLayout, h.distsScale);
+
+        size_t bytes;
+        mapGetDistsData(m, &bytes);
+
+        if(bytes!=h.distsBytes)
+        {
+            throwWarn("TSP Binary Reader", "Invalid distances size", filename);
+            mapDelete(m);
+            return NULL;
+        }
+    }
+
+    if(h.nbNeighbours>0)
+        mapUseNeighbours(m, (int*)(data+h.neighboursOffset), h.nbNeighbours);
+
+    Point p={0, 0};
+
+    for(int i=0; i<n; i++)
+    {
+        if(h.isPos)
+        {
+            p.x=xs[i];
+            p.y=ys[i];
+        }
+
+        mapAddCity(m, cityCreate(h.isPos, p));
+    }
+
+    return m;
+}
+
+/**
+ * \fn void tspBinWrite(Map m, Str filename)
+ * \brief Fonction qui écrit le cache binaire d'une Map (en-tête, coordonnées, matrice et listes de voisins si elles sont calculées).
+ * \param Map m : Map à écrire.
+ * \param Str filename : Chemin du fichier à écrire.
+ * \return void
+ */
+
+void tspBinWrite(Map m, Str filename)
+{
+    FILE *file=fopen(filename, "wb");
+
+    if(!file)
+        throwErr("TSP Binary Writer", "File could'nt be written", filename);
+
+    int n=mapGetSize(m);
+    size_t bytes;
+    const void *dists=mapGetDistsData(m, &bytes);
+
+    TspBinHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TSPBIN_MAGIC, sizeof(h.magic));
+    h.version=TSPBIN_VERSION;
+    h.endian=TSPBIN_ENDIAN;
+    h.nbCities=n;
+    h.isPos=mapGetIsPos(m);
+    h.lengthType=mapGetLengthType(m);
+    h.distsLayout=mapGetDistsLayout(m);
+    h.distsType=mapGetDistsType(m);
+    h.nbNeighbours=mapGetNbNeighbours(m);
+    h.distsScale=mapGetDistsScale(m);
+
+    uint64_t end=sizeof(h);
+
+    if(h.isPos)
+    {
+        h.coordsOffset=tspBinAlign(end);
+        end=h.coordsOffset+2*(uint64_t)n*sizeof(double);
+    }
+    if(dists)
+    {
+        h.distsOffset=tspBinAlign(end);
+        h.distsBytes=bytes;
+        end=h.distsOffset+bytes;
+    }
+    if(h.nbNeighbours>0)
+        h.neighboursOffset=tspBinAlign(end);
+
+    uint64_t pos=fwrite(&h, 1, sizeof(h), file);
+
+    if(h.isPos)
+    {
+        tspBinPad(file, &pos, h.coordsOffset);
+
+        for(int axis=0; axis<2; axis++) // abscisses puis ordonnées, comme les coordonnées d'une Map DISTS_LAZY
+        {
+            for(int i=0; i<n; i++)
+            {
+                Point p=cityGetPos(mapGetCity(m, i));
+                double val=axis==0 ? p.x : p.y;
+                pos+=fwrite(&val, 1, sizeof(double), file);
+            }
+        }
+    }
+    if(dists)
+    {
+        tspBinPad(file, &pos, h.distsOffset);
+        pos+=fwrite(dists, 1, bytes, file);
+    }
+    if(h.nbNeighbours>0)
+    {
+        tspBinPad(file, &pos, h.neighboursOffset);
+
+        for(int i=0; i<n; i++)
+        {
+            const int *nb=mapGetNeighbours(m, i);
+
+            for(int j=0; j<h.nbNeighbours; j++)
+            {
+                int32_t val=nb[j];
+                pos+=fwrite(&val, 1, sizeof(int32_t), file);
+            }
+        }
+    }
+
+    if(ferror(file))
+        throwErr("TSP Binary Writer", "File could'nt be written", filename);
+
+    fclose(file);
+}
@@ -0,0 +1,45 @@
+﻿/**
+ * \file tspbin.h
+ * \brief Fichier d'en-tête du cache binaire des Map (fichiers projetés en mémoire).
+ * \author Jason Pindat
+ * \version
+ * \date 2014
+ */
+
+#ifndef TSPBIN_H
+#define TSPBIN_H
+
+#include <stdbool.h>
+
+#include "map.h"
+#include "string.h"
+
+/**
+ * \fn bool tspBinIsFile(Str)
+ * \brief Fonction qui indique si un fichier est un cache binaire (d'après sa signature).
+ * \param Str : Chemin du fichier.
+ * \return true si le fichier commence par la signature du cache binaire.
+ */
+
+bool tspBinIsFile(Str);
+
+/**
+ * \fn Map tspBinLoad(Str)
+ * \brief Fonction qui ouvre un cache binaire et retourne la Map correspondante, sans copier la matrice.
+ * \param Str : Chemin du fichier.
+ * \return La Map, ou NULL si le fichier est invalide.
+ */
+
+Map tspBinLoad(Str);
+
+/**
+ * \fn void tspBinWrite(Map, Str)
+ * \brief Fonction qui écrit le cache binaire d'une Map (en-tête, coordonnées, matrice et listes de voisins si elles sont calculées).
+ * \param Map : Map à écrire.
+ * \param Str : Chemin du fichier à écrire.
+ * \return void
+ */
+
+void tspBinWrite(Map, Str);
+
+#endif